@@ -1,6 +1,20 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <optional>
 #include <queue>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 template <typename T>
@@ -19,9 +33,30 @@ class AVL
 
         Node* root{nullptr};
 
+        static constexpr size_t BATCH_LANES = 16;                                               /// lookups advanced in lockstep by search_batch
+
+        /// snapshot layout: header, count keys in order, count heights (one byte each)
+        struct SnapshotHeader
+        {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t keySize;
+            uint64_t count;
+            uint64_t checksum;
+        };
+        static constexpr uint64_t SNAPSHOT_MAGIC = 0x31504E534C5641ULL;                        /// "AVLSNP1"
+        static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
         /// HELPERS
+        static void prefetch(const Node* node);
         Node* clear(Node* node);
         Node* copyTree(Node* node);
+        template<typename F>
+        void forEachInorder(F&& visit) const;                                                   /// iterative, no visitor pointer
+        static Node* buildFromSnapshot(const T* keys, const uint8_t* heights, size_t count);
+        static uint64_t snapshotChecksum(const T* keys, const uint8_t* heights, size_t count);
+        static void writeAll(int fd, const void* data, size_t size);
+        static void readAll(int fd, void* data, size_t size);
         Node* Rinsert(Node* node, const T& value);                                              /// recursive insert
         Node* RdeleteNode(Node* node, const T& value);                                          /// recursive delete
         void inorder(const typename AVL<T>::Node* node, void (*visitor)(const T&) = nullptr);   /// traversals - inorder postorder preorder levelorder
@@ -29,6 +64,29 @@ class AVL
         void postorder(const typename AVL<T>::Node* node, void (*visitor)(const T&) = nullptr);
 
     public:
+        class Snapshot                                                                          /// read-only mapping of a saved tree
+        {
+            private:
+                void* base{nullptr};
+                size_t length{0};
+                const T* m_keys{nullptr};
+                const uint8_t* m_heights{nullptr};
+                size_t count{0};
+
+            public:
+                explicit Snapshot(int fd);                                                      /// maps the whole file read-only
+                Snapshot(const Snapshot&) = delete;
+                Snapshot& operator=(const Snapshot&) = delete;
+                Snapshot(Snapshot&& src) noexcept;
+                Snapshot& operator=(Snapshot&& rhs) noexcept;
+                ~Snapshot();
+
+                std::optional<T> search(const T& key) const;                                    /// binary search over the mapped keys
+                std::span<const T> keys() const;
+                std::span<const uint8_t> heights() const;
+                size_t size() const;
+        };
+
         AVL() = default;                                                                        /// default ctor
         AVL(const std::initializer_list<T>& list);                                              /// initializer_list ctor
                                                     
@@ -44,6 +102,8 @@ class AVL
         const T& getValue(typename AVL<T>::Node*) const;                                        /// getValue
                                                                                                 /// clean
         std::optional<T> search(const T& key);                                                  /// search iterative
+        void search_batch(std::span<const T> keys, std::span<std::optional<T>> out);            /// interleaved lookups, prefetching each next level
+        void search_batch_sorted(std::span<const T> keys, std::span<std::optional<T>> out);     /// ascending keys, reuses the common path prefix
 
         int getHeight(Node* node);                                                              /// getHeight recursive
         int BalanceFactor(Node* node);                                                          /// Balance Factor
@@ -69,6 +129,9 @@ class AVL
 
         void levelOrder(void (*visitor)(const T&) = [](const int& a) {std::cout << a << std::endl;});
 
+        void save(int fd) const;                                                                /// trivially copyable keys only
+        void load(int fd);                                                                      /// O(n) rebuild, no rotations
+
 };
 
 
@@ -123,6 +186,7 @@ typename AVL<T>::Node* AVL<T>::copyTree(Node* node)      ///deep copy
         return nullptr;
 
     Node* newNode = new Node{node->value};
+    newNode->height = node->height;
     newNode->left = copyTree(node->left);
     newNode->right = copyTree(node->right);
 
@@ -171,6 +235,133 @@ std::optional<T> AVL<T>::search(const T& key)
 
 }
 
+template<typename T>
+void AVL<T>::prefetch(const Node* node)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(node);
+#else
+    (void)node;
+#endif
+}
+
+template<typename T>
+void AVL<T>::search_batch(std::span<const T> keys, std::span<std::optional<T>> out)
+{
+    if(out.size() < keys.size())
+        throw std::invalid_argument("output span is smaller than key span");
+
+    /// every lane walks one level per round, so the misses of up to BATCH_LANES descents overlap
+    for(size_t base = 0; base < keys.size(); base += BATCH_LANES)
+    {
+        const size_t lanes = std::min(BATCH_LANES, keys.size() - base);
+        Node* cursor[BATCH_LANES];
+        for(size_t i = 0; i < lanes; ++i)
+        {
+            cursor[i] = root;
+            out[base + i] = std::nullopt;
+        }
+
+        size_t active = lanes;
+        while(active != 0)
+        {
+            active = 0;
+            for(size_t i = 0; i < lanes; ++i)
+            {
+                Node* current = cursor[i];
+                if(!current)
+                    continue;
+                const T& key = keys[base + i];
+                if(key < current->value)
+                    current = current->left;
+                else if(current->value < key)
+                    current = current->right;
+                else
+                {
+                    out[base + i] = current->value;
+                    cursor[i] = nullptr;
+                    continue;
+                }
+                if(current)
+                {
+                    prefetch(current);
+                    ++active;
+                }
+                cursor[i] = current;
+            }
+        }
+    }
+}
+
+template<typename T>
+void AVL<T>::search_batch_sorted(std::span<const T> keys, std::span<std::optional<T>> out)
+{
+    if(out.size() < keys.size())
+        throw std::invalid_argument("output span is smaller than key span");
+
+    /// path from root to the last visited node; upper is the exclusive upper bound of that node's subtree
+    /// (nullptr = unbounded). keys are ascending, so only the upper bound can rule a subtree out
+    struct Step
+    {
+        Node* node;
+        const T* upper;
+    };
+    std::vector<Step> path;
+    path.reserve(root ? root->height + 2 : 1);
+
+    for(size_t i = 0; i < keys.size(); ++i)
+    {
+        const T& key = keys[i];
+        if(i != 0 && key < keys[i-1])
+            throw std::invalid_argument("keys are not sorted");
+
+        while(!path.empty() && path.back().upper && !(key < *path.back().upper))
+            path.pop_back();
+
+        Node* current = root;
+        const T* upper = nullptr;
+        if(!path.empty())
+        {
+            const Step& last = path.back();
+            if(key < last.node->value)
+            {
+                current = last.node->left;
+                upper = &last.node->value;
+            }
+            else if(last.node->value < key)
+            {
+                current = last.node->right;
+                upper = last.upper;
+            }
+            else
+            {
+                out[i] = last.node->value;
+                continue;
+            }
+        }
+
+        out[i] = std::nullopt;
+        while(current)
+        {
+            path.push_back({current, upper});
+            if(key < current->value)
+            {
+                upper = &current->value;
+                current = current->left;
+            }
+            else if(current->value < key)
+                current = current->right;
+            else
+            {
+                out[i] = current->value;
+                break;
+            }
+            if(current)
+                prefetch(current);
+        }
+    }
+}
+
 template<typename T>                                                              //// get Height
 int AVL<T>::getHeight(typename AVL<T>::Node* node)
 {
@@ -262,7 +453,7 @@ typename AVL<T>::Node* AVL<T>::leftRotation(Node* node)
     
     /// update heights of rotated nodes
     node->height = std::max(getHeight(node->left), getHeight(node->right)) + 1;
-    tmpNode->height = std::max(getHeight(node->left), getHeight(node->right)) + 1;
+    tmpNode->height = std::max(getHeight(tmpNode->left), getHeight(tmpNode->right)) + 1;
 
     return tmpNode;
 }
@@ -276,7 +467,7 @@ typename AVL<T>::Node* AVL<T>::rightRotation(Node* node)
     
     /// update heights of rotated nodes
     node->height = std::max(getHeight(node->left), getHeight(node->right)) + 1;
-    tmpNode->height = std::max(getHeight(node->left), getHeight(node->right)) + 1;
+    tmpNode->height = std::max(getHeight(tmpNode->left), getHeight(tmpNode->right)) + 1;
 
     return tmpNode;
 }
@@ -285,9 +476,8 @@ typename AVL<T>::Node* AVL<T>::rightRotation(Node* node)
 template<typename T>
 typename AVL<T>::Node* AVL<T>::Rinsert(Node* node, const T& value)
 {
-    Node* newNode = new Node{value};
     if(!node)
-        return newNode;
+        return new Node{value};
 
     if(value > node->value)
         node->right = Rinsert(node->right, value);
@@ -465,4 +655,270 @@ void AVL<T>::levelOrder(void (*visitor)(const T&))
         if(node->right)
             q.push(node->right);
     }
-}
\ No newline at end of file
+}
+
+template<typename T>
+template<typename F>
+void AVL<T>::forEachInorder(F&& visit) const
+{
+    std::vector<const Node*> stack;
+    stack.reserve(root ? root->height + 1 : 0);
+    const Node* current = root;
+    while(current || !stack.empty())
+    {
+        while(current)
+        {
+            stack.push_back(current);
+            current = current->left;
+        }
+        current = stack.back();
+        stack.pop_back();
+        visit(*current);
+        current = current->right;
+    }
+}
+
+template<typename T>
+uint64_t AVL<T>::snapshotChecksum(const T* keys, const uint8_t* heights, size_t count)   /// FNV-1a over keys, then heights
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(keys);
+    for(size_t i = 0; i < count * sizeof(T); ++i)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    for(size_t i = 0; i < count; ++i)
+        hash = (hash ^ heights[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+template<typename T>
+void AVL<T>::writeAll(int fd, const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while(size != 0)
+    {
+        ssize_t written = ::write(fd, bytes, size);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "AVL snapshot write");
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+template<typename T>
+void AVL<T>::readAll(int fd, void* data, size_t size)
+{
+    char* bytes = static_cast<char*>(data);
+    while(size != 0)
+    {
+        ssize_t got = ::read(fd, bytes, size);
+        if(got < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "AVL snapshot read");
+        }
+        if(got == 0)
+            throw std::runtime_error("AVL snapshot is truncated");
+        bytes += got;
+        size -= static_cast<size_t>(got);
+    }
+}
+
+template<typename T>
+void AVL<T>::save(int fd) const
+{
+    static_assert(std::is_trivially_copyable_v<T>, "AVL snapshots need trivially copyable keys");
+
+    /// the inorder key array plus every node's height pins down the exact shape,
+    /// so load needs neither comparisons nor rotations
+    std::vector<T> keys;
+    std::vector<uint8_t> heights;
+    forEachInorder([&](const Node& node)
+    {
+        keys.push_back(node.value);
+        heights.push_back(static_cast<uint8_t>(node.height));
+    });
+
+    SnapshotHeader header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.keySize = sizeof(T);
+    header.count = keys.size();
+    header.checksum = snapshotChecksum(keys.data(), heights.data(), keys.size());
+
+    writeAll(fd, &header, sizeof(header));
+    writeAll(fd, keys.data(), keys.size() * sizeof(T));
+    writeAll(fd, heights.data(), heights.size());
+}
+
+template<typename T>
+typename AVL<T>::Node* AVL<T>::buildFromSnapshot(const T* keys, const uint8_t* heights, size_t count)
+{
+    /// within any subtree's inorder range its root is the unique tallest node,
+    /// so the tree is the max-height cartesian tree of the sequence
+    std::vector<Node*> stack;
+    Node* result = nullptr;
+    try
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            if(i != 0 && !(keys[i-1] < keys[i]))
+                throw std::runtime_error("AVL snapshot keys are not strictly increasing");
+
+            Node* node = new Node{keys[i]};
+            node->height = heights[i];
+            Node* last = nullptr;
+            while(!stack.empty() && stack.back()->height < node->height)
+            {
+                last = stack.back();
+                stack.pop_back();
+            }
+            node->left = last;
+            if(!stack.empty())
+                stack.back()->right = node;
+            stack.push_back(node);
+        }
+        result = stack.empty() ? nullptr : stack.front();
+    }
+    catch(...)
+    {
+        /// every allocated node is reachable from the bottom of the stack
+        AVL<T> tmp;
+        tmp.root = stack.empty() ? nullptr : stack.front();
+        throw;
+    }
+    return result;
+}
+
+template<typename T>
+void AVL<T>::load(int fd)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "AVL snapshots need trivially copyable keys");
+
+    AVL<T> tmp;
+    struct stat info{};
+    if(::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && ::lseek(fd, 0, SEEK_CUR) == 0)
+    {
+        Snapshot snapshot{fd};
+        tmp.root = buildFromSnapshot(snapshot.keys().data(), snapshot.heights().data(), snapshot.size());
+        ::lseek(fd, static_cast<off_t>(sizeof(SnapshotHeader) + snapshot.size() * (sizeof(T) + 1)), SEEK_SET);
+    }
+    else                                                                                        /// pipes and sockets - read sequentially
+    {
+        SnapshotHeader header{};
+        readAll(fd, &header, sizeof(header));
+        if(header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.keySize != sizeof(T))
+            throw std::runtime_error("not an AVL snapshot for this key type");
+
+        std::vector<T> keys(header.count);
+        std::vector<uint8_t> heights(header.count);
+        readAll(fd, keys.data(), keys.size() * sizeof(T));
+        readAll(fd, heights.data(), heights.size());
+        if(snapshotChecksum(keys.data(), heights.data(), keys.size()) != header.checksum)
+            throw std::runtime_error("AVL snapshot checksum mismatch");
+        tmp.root = buildFromSnapshot(keys.data(), heights.data(), keys.size());
+    }
+    std::swap(root, tmp.root);
+}
+
+template<typename T>
+AVL<T>::Snapshot::Snapshot(int fd)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "AVL snapshots need trivially copyable keys");
+
+    struct stat info{};
+    if(::fstat(fd, &info) != 0)
+        throw std::system_error(errno, std::generic_category(), "AVL snapshot fstat");
+    length = static_cast<size_t>(info.st_size);
+    if(length < sizeof(SnapshotHeader))
+        throw std::runtime_error("AVL snapshot is truncated");
+
+    base = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(base == MAP_FAILED)
+    {
+        base = nullptr;
+        throw std::system_error(errno, std::generic_category(), "AVL snapshot mmap");
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    const char* payload = static_cast<const char*>(base) + sizeof(SnapshotHeader);
+    if(header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.keySize != sizeof(T)
+       || header.count > (length - sizeof(SnapshotHeader)) / (sizeof(T) + 1))
+    {
+        ::munmap(base, length);
+        base = nullptr;
+        throw std::runtime_error("not an AVL snapshot for this key type");
+    }
+    count = header.count;
+    m_keys = reinterpret_cast<const T*>(payload);
+    m_heights = reinterpret_cast<const uint8_t*>(payload + count * sizeof(T));
+    if(snapshotChecksum(m_keys, m_heights, count) != header.checksum)
+    {
+        ::munmap(base, length);
+        base = nullptr;
+        throw std::runtime_error("AVL snapshot checksum mismatch");
+    }
+}
+
+template<typename T>
+AVL<T>::Snapshot::Snapshot(Snapshot&& src) noexcept
+                    : base{std::exchange(src.base, nullptr)},
+                      length{src.length},
+                      m_keys{src.m_keys},
+                      m_heights{src.m_heights},
+                      count{std::exchange(src.count, 0)}
+{}
+
+template<typename T>
+typename AVL<T>::Snapshot& AVL<T>::Snapshot::operator=(Snapshot&& rhs) noexcept
+{
+    if(&rhs == this)
+        return *this;
+    if(base)
+        ::munmap(base, length);
+    base = std::exchange(rhs.base, nullptr);
+    length = rhs.length;
+    m_keys = rhs.m_keys;
+    m_heights = rhs.m_heights;
+    count = std::exchange(rhs.count, 0);
+    return *this;
+}
+
+template<typename T>
+AVL<T>::Snapshot::~Snapshot()
+{
+    if(base)
+        ::munmap(base, length);
+}
+
+template<typename T>
+std::optional<T> AVL<T>::Snapshot::search(const T& key) const
+{
+    const T* it = std::lower_bound(m_keys, m_keys + count, key);
+    if(it != m_keys + count && !(key < *it))
+        return *it;
+    return std::nullopt;
+}
+
+template<typename T>
+std::span<const T> AVL<T>::Snapshot::keys() const
+{
+    return {m_keys, count};
+}
+
+template<typename T>
+std::span<const uint8_t> AVL<T>::Snapshot::heights() const
+{
+    return {m_heights, count};
+}
+
+template<typename T>
+size_t AVL<T>::Snapshot::size() const
+{
+    return count;
+}
@@ -0,0 +1,467 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "AVL_Tree.h"
+
+
+/// AVL tree whose nodes live in one array and link to each other by 32-bit index.
+/// Height is replaced by a 2-bit balance factor packed next to the left index,
+/// so for 4-byte keys a node is 12 bytes instead of 32.
+template <typename T>
+class CompactAVL
+{
+    private:
+        static constexpr uint32_t NIL = (1U << 30) - 1;                                         /// null index, also the node limit
+        enum Balance : uint32_t { BALANCED = 0, LEFT_HEAVY = 1, RIGHT_HEAVY = 2 };
+
+        class Node
+        {
+            public:
+                T value;
+                uint32_t left : 30;
+                uint32_t balance : 2;
+                uint32_t right;
+                Node(T data) : value{std::move(data)}, left{NIL}, balance{BALANCED}, right{NIL} {};
+        };
+
+        std::vector<Node> nodes;
+        uint32_t root{NIL};
+        uint32_t freeList{NIL};                                                                 /// erased slots, chained through right
+        size_t count{0};
+
+        /// HELPERS
+        template<typename U>
+        uint32_t allocate(U&& value);
+        void release(uint32_t index);
+        uint32_t rotateLeft(uint32_t index);
+        uint32_t rotateRight(uint32_t index);
+        uint32_t fixLeftHeavy(uint32_t index, bool& shorter);                                   /// left subtree is 2 taller
+        uint32_t fixRightHeavy(uint32_t index, bool& shorter);                                  /// right subtree is 2 taller
+        uint32_t leftShrunk(uint32_t index, bool& shorter);
+        uint32_t rightShrunk(uint32_t index, bool& shorter);
+        template<typename U>
+        uint32_t Rinsert(uint32_t index, U&& value, bool& taller);                              /// recursive insert
+        uint32_t RdeleteNode(uint32_t index, const T& value, bool& shorter);                    /// recursive delete
+        uint32_t RremoveMin(uint32_t index, bool& shorter, uint32_t& minIndex);
+        void inorder(uint32_t index, void (*visitor)(const T&)) const;
+        void preorder(uint32_t index, void (*visitor)(const T&)) const;
+        void postorder(uint32_t index, void (*visitor)(const T&)) const;
+
+    public:
+        CompactAVL() = default;
+        CompactAVL(const std::initializer_list<T>& list);
+
+        CompactAVL(const CompactAVL<T>& src) = default;                                         /// nodes are plain array slots
+        CompactAVL<T>& operator=(const CompactAVL<T>& rhs) = default;
+        CompactAVL(CompactAVL<T>&& src) noexcept = default;
+        CompactAVL<T>& operator=(CompactAVL<T>&& rhs) noexcept = default;
+        ~CompactAVL() = default;
+
+        std::optional<T> search(const T& key) const;                                            /// search iterative
+
+        template<typename U>
+        void insert(U&& value);
+        template<typename U>
+        void deleteNode(U&& value);
+
+        int getHeight() const;                                                                  /// follows the taller side, O(log n)
+        size_t size() const;
+        bool isEmpty() const;
+        void reserve(size_t n);
+        void clear();
+
+        void inorderTraversal(void (*visitor)(const T&) = [](const T& a) {std::cout << a << std::endl;}) const;
+        void preorderTraversal(void (*visitor)(const T&) = [](const T& a) {std::cout << a << std::endl;}) const;
+        void postorderTraversal(void (*visitor)(const T&) = [](const T& a) {std::cout << a << std::endl;}) const;
+
+        void levelOrder(void (*visitor)(const T&) = [](const T& a) {std::cout << a << std::endl;}) const;
+};
+
+/// compile-time choice between the pointer-based and the compact node layout
+template<typename T, bool Compact = false>
+using AVLTree = std::conditional_t<Compact, CompactAVL<T>, AVL<T>>;
+
+
+template<typename T>
+CompactAVL<T>::CompactAVL(const std::initializer_list<T>& list)
+{
+    nodes.reserve(list.size());
+    for(const T& item : list)
+    {
+        insert(item);
+    }
+}
+
+template<typename T>
+template<typename U>
+uint32_t CompactAVL<T>::allocate(U&& value)
+{
+    if(freeList != NIL)
+    {
+        uint32_t index = freeList;
+        freeList = nodes[index].right;
+        nodes[index].value = std::forward<U>(value);
+        nodes[index].left = NIL;
+        nodes[index].right = NIL;
+        nodes[index].balance = BALANCED;
+        return index;
+    }
+    if(nodes.size() >= NIL)
+        throw std::length_error("CompactAVL node limit reached");
+    nodes.emplace_back(T(std::forward<U>(value)));
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+template<typename T>
+void CompactAVL<T>::release(uint32_t index)
+{
+    nodes[index].right = freeList;
+    freeList = index;
+}
+
+template<typename T>
+uint32_t CompactAVL<T>::rotateLeft(uint32_t index)
+{
+    uint32_t tmp = nodes[index].right;
+    nodes[index].right = nodes[tmp].left;
+    nodes[tmp].left = index;
+    return tmp;
+}
+
+template<typename T>
+uint32_t CompactAVL<T>::rotateRight(uint32_t index)
+{
+    uint32_t tmp = nodes[index].left;
+    nodes[index].left = nodes[tmp].right;
+    nodes[tmp].right = index;
+    return tmp;
+}
+
+template<typename T>
+uint32_t CompactAVL<T>::fixLeftHeavy(uint32_t index, bool& shorter)
+{
+    uint32_t L = nodes[index].left;
+    if(nodes[L].balance != RIGHT_HEAVY)                                                         /// LL case - single rotation
+    {
+        shorter = nodes[L].balance == LEFT_HEAVY;                                               /// a balanced child only happens on delete
+        nodes[index].balance = shorter ? BALANCED : LEFT_HEAVY;
+        nodes[L].balance = shorter ? BALANCED : RIGHT_HEAVY;
+        return rotateRight(index);
+    }
+
+    uint32_t LR = nodes[L].right;                                                               /// LR case - double rotation
+    nodes[index].balance = nodes[LR].balance == LEFT_HEAVY ? RIGHT_HEAVY : BALANCED;
+    nodes[L].balance = nodes[LR].balance == RIGHT_HEAVY ? LEFT_HEAVY : BALANCED;
+    nodes[LR].balance = BALANCED;
+    nodes[index].left = rotateLeft(L);
+    shorter = true;
+    return rotateRight(index);
+}
+
+template<typename T>
+uint32_t CompactAVL<T>::fixRightHeavy(uint32_t index, bool& shorter)
+{
+    uint32_t R = nodes[index].right;
+    if(nodes[R].balance != LEFT_HEAVY)                                                          /// RR case - single rotation
+    {
+        shorter = nodes[R].balance == RIGHT_HEAVY;
+        nodes[index].balance = shorter ? BALANCED : RIGHT_HEAVY;
+        nodes[R].balance = shorter ? BALANCED : LEFT_HEAVY;
+        return rotateLeft(index);
+    }
+
+    uint32_t RL = nodes[R].left;                                                                /// RL case - double rotation
+    nodes[index].balance = nodes[RL].balance == RIGHT_HEAVY ? LEFT_HEAVY : BALANCED;
+    nodes[R].balance = nodes[RL].balance == LEFT_HEAVY ? RIGHT_HEAVY : BALANCED;
+    nodes[RL].balance = BALANCED;
+    nodes[index].right = rotateRight(R);
+    shorter = true;
+    return rotateLeft(index);
+}
+
+template<typename T>
+uint32_t CompactAVL<T>::leftShrunk(uint32_t index, bool& shorter)
+{
+    switch(nodes[index].balance)
+    {
+        case LEFT_HEAVY:
+            nodes[index].balance = BALANCED;
+            shorter = true;
+            return index;
+        case BALANCED:
+            nodes[index].balance = RIGHT_HEAVY;
+            shorter = false;
+            return index;
+        default:
+            return fixRightHeavy(index, shorter);
+    }
+}
+
+template<typename T>
+uint32_t CompactAVL<T>::rightShrunk(uint32_t index, bool& shorter)
+{
+    switch(nodes[index].balance)
+    {
+        case RIGHT_HEAVY:
+            nodes[index].balance = BALANCED;
+            shorter = true;
+            return index;
+        case BALANCED:
+            nodes[index].balance = LEFT_HEAVY;
+            shorter = false;
+            return index;
+        default:
+            return fixLeftHeavy(index, shorter);
+    }
+}
+
+template<typename T>
+template<typename U>
+uint32_t CompactAVL<T>::Rinsert(uint32_t index, U&& value, bool& taller)
+{
+    if(index == NIL)
+    {
+        taller = true;
+        ++count;
+        return allocate(std::forward<U>(value));
+    }
+
+    bool shorter = false;
+    if(value < nodes[index].value)
+    {
+        uint32_t child = Rinsert(nodes[index].left, std::forward<U>(value), taller);           /// may reallocate nodes
+        nodes[index].left = child;
+        if(!taller)
+            return index;
+        switch(nodes[index].balance)
+        {
+            case RIGHT_HEAVY:
+                nodes[index].balance = BALANCED;
+                taller = false;
+                return index;
+            case BALANCED:
+                nodes[index].balance = LEFT_HEAVY;
+                return index;
+            default:
+                taller = false;
+                return fixLeftHeavy(index, shorter);
+        }
+    }
+    else if(nodes[index].value < value)
+    {
+        uint32_t child = Rinsert(nodes[index].right, std::forward<U>(value), taller);
+        nodes[index].right = child;
+        if(!taller)
+            return index;
+        switch(nodes[index].balance)
+        {
+            case LEFT_HEAVY:
+                nodes[index].balance = BALANCED;
+                taller = false;
+                return index;
+            case BALANCED:
+                nodes[index].balance = RIGHT_HEAVY;
+                return index;
+            default:
+                taller = false;
+                return fixRightHeavy(index, shorter);
+        }
+    }
+    taller = false;                                                                             ///equal keys are not alowed
+    return index;
+}
+
+template<typename T>
+template<typename U>
+void CompactAVL<T>::insert(U&& value)
+{
+    bool taller = false;
+    root = Rinsert(root, std::forward<U>(value), taller);
+}
+
+template<typename T>
+uint32_t CompactAVL<T>::RremoveMin(uint32_t index, bool& shorter, uint32_t& minIndex)
+{
+    if(nodes[index].left == NIL)
+    {
+        minIndex = index;
+        shorter = true;
+        return nodes[index].right;
+    }
+    nodes[index].left = RremoveMin(nodes[index].left, shorter, minIndex);
+    return shorter ? leftShrunk(index, shorter) : index;
+}
+
+template<typename T>
+uint32_t CompactAVL<T>::RdeleteNode(uint32_t index, const T& value, bool& shorter)
+{
+    if(index == NIL)
+    {
+        shorter = false;
+        return NIL;
+    }
+
+    if(value < nodes[index].value)
+    {
+        nodes[index].left = RdeleteNode(nodes[index].left, value, shorter);
+        return shorter ? leftShrunk(index, shorter) : index;
+    }
+    if(nodes[index].value < value)
+    {
+        nodes[index].right = RdeleteNode(nodes[index].right, value, shorter);
+        return shorter ? rightShrunk(index, shorter) : index;
+    }
+
+    --count;
+    if(nodes[index].left == NIL || nodes[index].right == NIL)
+    {
+        uint32_t child = nodes[index].left == NIL ? nodes[index].right : nodes[index].left;
+        release(index);
+        shorter = true;
+        return child;
+    }
+
+    uint32_t minIndex = NIL;                                                                    /// pull the successor up into this slot
+    nodes[index].right = RremoveMin(nodes[index].right, shorter, minIndex);
+    nodes[index].value = std::move(nodes[minIndex].value);
+    release(minIndex);
+    return shorter ? rightShrunk(index, shorter) : index;
+}
+
+template<typename T>
+template<typename U>
+void CompactAVL<T>::deleteNode(U&& value)
+{
+    bool shorter = false;
+    root = RdeleteNode(root, value, shorter);
+}
+
+template<typename T>
+std::optional<T> CompactAVL<T>::search(const T& key) const
+{
+    uint32_t current = root;
+    while(current != NIL)
+    {
+        const Node& node = nodes[current];
+        if(key < node.value)
+            current = node.left;
+        else if(node.value < key)
+            current = node.right;
+        else
+            return node.value;
+    }
+    return std::nullopt;
+}
+
+template<typename T>
+int CompactAVL<T>::getHeight() const
+{
+    int height = -1;
+    uint32_t current = root;
+    while(current != NIL)
+    {
+        ++height;
+        current = nodes[current].balance == RIGHT_HEAVY ? nodes[current].right : nodes[current].left;
+    }
+    return height;
+}
+
+template<typename T>
+size_t CompactAVL<T>::size() const
+{
+    return count;
+}
+
+template<typename T>
+bool CompactAVL<T>::isEmpty() const
+{
+    return count == 0;
+}
+
+template<typename T>
+void CompactAVL<T>::reserve(size_t n)
+{
+    nodes.reserve(n);
+}
+
+template<typename T>
+void CompactAVL<T>::clear()
+{
+    nodes.clear();
+    root = NIL;
+    freeList = NIL;
+    count = 0;
+}
+
+template<typename T>
+void CompactAVL<T>::inorder(uint32_t index, void (*visitor)(const T&)) const
+{
+    if(index == NIL)
+        return;
+    inorder(nodes[index].left, visitor);
+    visitor(nodes[index].value);
+    inorder(nodes[index].right, visitor);
+}
+
+template<typename T>
+void CompactAVL<T>::inorderTraversal(void (*visitor)(const T&)) const
+{
+    inorder(root, visitor);
+}
+
+template<typename T>
+void CompactAVL<T>::preorder(uint32_t index, void (*visitor)(const T&)) const
+{
+    if(index == NIL)
+        return;
+    visitor(nodes[index].value);
+    preorder(nodes[index].left, visitor);
+    preorder(nodes[index].right, visitor);
+}
+
+template<typename T>
+void CompactAVL<T>::preorderTraversal(void (*visitor)(const T&)) const
+{
+    preorder(root, visitor);
+}
+
+template<typename T>
+void CompactAVL<T>::postorder(uint32_t index, void (*visitor)(const T&)) const
+{
+    if(index == NIL)
+        return;
+    postorder(nodes[index].left, visitor);
+    postorder(nodes[index].right, visitor);
+    visitor(nodes[index].value);
+}
+
+template<typename T>
+void CompactAVL<T>::postorderTraversal(void (*visitor)(const T&)) const
+{
+    postorder(root, visitor);
+}
+
+template<typename T>
+void CompactAVL<T>::levelOrder(void (*visitor)(const T&)) const
+{
+    if(root == NIL)
+        return;
+    std::queue<uint32_t> q;
+    q.push(root);
+
+    while(!q.empty())
+    {
+        const Node& node = nodes[q.front()];
+        q.pop();
+        visitor(node.value);
+        if(node.left != NIL)
+            q.push(node.left);
+        if(node.right != NIL)
+            q.push(node.right);
+    }
+}
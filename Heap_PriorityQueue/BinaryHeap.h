@@ -3,132 +3,255 @@
 #include <vector>
 #include <cmath>
 #include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <utility>
 
 
-/// MAXHEAP imlementation - Priority Queue
+/// Allocator that places element 1 of the buffer on a cache line boundary.
+/// In a d-ary heap the children of node i are d*i+1 .. d*i+d, so when d*sizeof(T)
+/// divides the line size every sibling group sits inside a single cache line.
 template<typename T>
+class SiblingAlignedAllocator
+{
+    public:
+        using value_type = T;
+        static constexpr size_t LINE = 64;
+        static constexpr size_t SHIFT = sizeof(T) < LINE ? LINE - sizeof(T) : 0;
+
+        SiblingAlignedAllocator() = default;
+        template<typename U>
+        SiblingAlignedAllocator(const SiblingAlignedAllocator<U>&) noexcept {}
+
+        T* allocate(size_t n)
+        {
+            char* raw = static_cast<char*>(::operator new(n * sizeof(T) + SHIFT, std::align_val_t{LINE}));
+            return reinterpret_cast<T*>(raw + SHIFT);
+        }
+        void deallocate(T* ptr, size_t n) noexcept
+        {
+            ::operator delete(reinterpret_cast<char*>(ptr) - SHIFT, n * sizeof(T) + SHIFT, std::align_val_t{LINE});
+        }
+
+        template<typename U>
+        bool operator==(const SiblingAlignedAllocator<U>&) const noexcept { return true; }
+        template<typename U>
+        bool operator!=(const SiblingAlignedAllocator<U>&) const noexcept { return false; }
+};
+
+
+/// MAXHEAP imlementation - Priority Queue
+/// Arity children per node; 4 or 8 halve or third the height of a binary heap.
+/// Compare orders elements like std::priority_queue: std::less keeps the largest
+/// element on top, std::greater the smallest.
+template<typename T, size_t Arity = 2, typename Compare = std::less<T>>
 class Heap
 {
+    static_assert(Arity == 2 || Arity == 4 || Arity == 8, "Heap arity must be 2, 4 or 8");
+
     private:
-        size_t heap_size;
-        std::vector<T> array;
-        void maxHeapify(size_t index);
-        void buildMaxHeap();
+        std::vector<T, SiblingAlignedAllocator<T>> array;
+        Compare comp;
+        void siftUp(size_t index);                      ///hole-based, elements are moved not swapped
+        void siftDown(size_t index);
+        void buildHeap();                               ///Floyd, O(n)
+
+        static size_t parent(size_t index) { return (index - 1) / Arity; }
+        static size_t firstChild(size_t index) { return Arity * index + 1; }
 
     public:
-        Heap();
+        Heap() = default;
+        explicit Heap(const Compare& compare);
         Heap(const std::initializer_list<T>& list);
 
-        Heap(const Heap<T>& src) = default;
-        Heap<T>& operator=(const Heap<T>& rhs) = default;
+        Heap(const Heap& src) = default;
+        Heap& operator=(const Heap& rhs) = default;
 
-        Heap(Heap<T>&& src) = default;                      
-        Heap<T>& operator=(Heap<T>&& rhs) = default;
+        Heap(Heap&& src) = default;
+        Heap& operator=(Heap&& rhs) = default;
 
         ~Heap() = default;
 
         void insert(T value);                           ////////////////  TC log n
+        template<typename... Args>
+        void emplace(Args&&... args);                   ////////////////  TC log n
+        template<typename InputIt>
+        void push_range(InputIt first, InputIt last);   ////////////////  TC min(k log n, n + k)
         void print() const;
         T extractMax();                                 ////////////////  TC log n
-        T getMax() const;                               ////////////////  TC O(1)
-        void increaseKey(size_t index,size_t value);    ////////////////  TC log n
+        const T& getMax() const;                        ////////////////  TC O(1)
+        void increaseKey(size_t index, T value);        ////////////////  TC log n
+        void reserve(size_t n);
+        void clear();                                   /// keeps the capacity
+        size_t size() const;
+        bool isEmpty() const;
 };
 
-template<typename T>
-Heap<T>::Heap() : heap_size{0} {}
+template<typename T, size_t Arity, typename Compare>
+Heap<T, Arity, Compare>::Heap(const Compare& compare) : comp{compare} {}
 
-template<typename T>
-Heap<T>::Heap(const std::initializer_list<T>& list) 
-                        : array{list.begin(),list.end()},
-                          heap_size{list.size()}
+template<typename T, size_t Arity, typename Compare>
+Heap<T, Arity, Compare>::Heap(const std::initializer_list<T>& list)
+                        : array{list.begin(),list.end()}
 {
-    buildMaxHeap();
+    buildHeap();
 }
 
-template<typename T>
-void Heap<T>::maxHeapify(size_t index)
-{
-    size_t L = 2*index + 1;
-    size_t R = 2*index + 2;
-    size_t largest = index;
-    if(L < heap_size && array[index] < array[L])
-        largest = L;
-    if(R < heap_size && array[largest] < array[R])
-        largest = R;
-    if(largest != index)
+template<typename T, size_t Arity, typename Compare>
+void Heap<T, Arity, Compare>::siftUp(size_t index)
+{
+    T tmp = std::move(array[index]);
+    while(index != 0 && comp(array[parent(index)], tmp))
     {
-        std::swap(array[index],array[largest]);
-        maxHeapify(largest);
+        array[index] = std::move(array[parent(index)]);
+        index = parent(index);
     }
+    array[index] = std::move(tmp);
 }
 
-template<typename T>
-void Heap<T>::buildMaxHeap()
+template<typename T, size_t Arity, typename Compare>
+void Heap<T, Arity, Compare>::siftDown(size_t index)
 {
-    size_t i = heap_size / 2 - 1;                                   ///last root node // bottom up cheaking
+    const size_t heap_size = array.size();
+    T tmp = std::move(array[index]);
+    while(true)
+    {
+        size_t first = firstChild(index);
+        if(first >= heap_size)
+            break;
+        size_t last = std::min(first + Arity, heap_size);
+        size_t best = first;                                        ///pick the best sibling, then one compare against the hole
+        for(size_t child = first + 1; child < last; ++child)
+        {
+            if(comp(array[best], array[child]))
+                best = child;
+        }
+        if(!comp(tmp, array[best]))
+            break;
+        array[index] = std::move(array[best]);
+        index = best;
+    }
+    array[index] = std::move(tmp);
+}
+
+template<typename T, size_t Arity, typename Compare>
+void Heap<T, Arity, Compare>::buildHeap()
+{
+    if(array.size() < 2)
+        return;
+    size_t i = parent(array.size() - 1);                            ///last root node // bottom up cheaking
     while(i != SIZE_MAX)
     {
-        maxHeapify(i);
+        siftDown(i);
         --i;
-    }   
+    }
 }
 
-template<typename T>
-void Heap<T>::insert(T value)
+template<typename T, size_t Arity, typename Compare>
+void Heap<T, Arity, Compare>::insert(T value)
 {
     array.push_back(std::move(value));
-    ++heap_size;
+    siftUp(array.size() - 1);
+}
+
+template<typename T, size_t Arity, typename Compare>
+template<typename... Args>
+void Heap<T, Arity, Compare>::emplace(Args&&... args)
+{
+    array.emplace_back(std::forward<Args>(args)...);
+    siftUp(array.size() - 1);
+}
 
-    size_t curindex = heap_size - 1;
-    size_t parent = (curindex - 1)/2;
+template<typename T, size_t Arity, typename Compare>
+template<typename InputIt>
+void Heap<T, Arity, Compare>::push_range(InputIt first, InputIt last)
+{
+    const size_t old_size = array.size();
+    array.insert(array.end(), first, last);
+    const size_t added = array.size() - old_size;
 
-    const T tmp = array[curindex];
-    while(tmp > array[parent] && curindex != 0)
+    /// k sift-ups cost about k*log(n), a full rebuild n+k - take the cheaper one
+    size_t log_n = 0;
+    for(size_t n = array.size(); n > 1; n /= Arity)
+        ++log_n;
+    if(added * log_n > array.size())
     {
-        array[curindex] = array[parent];
-        curindex = parent;
-        parent = (curindex - 1)/2;
+        buildHeap();
+        return;
     }
-    array[curindex] = tmp;
+    for(size_t i = old_size; i < array.size(); ++i)
+        siftUp(i);
 }
 
-template<typename T>
-T Heap<T>::extractMax()
+template<typename T, size_t Arity, typename Compare>
+T Heap<T, Arity, Compare>::extractMax()
 {
-    std::swap(array[0],array[heap_size-1]);
-    --heap_size;
-    maxHeapify(0);
-    return array[heap_size];
+    if(array.empty())
+        throw std::range_error("heap is empty");
+    T max = std::move(array[0]);
+    if(array.size() > 1)
+    {
+        array[0] = std::move(array.back());
+        array.pop_back();
+        siftDown(0);
+    }
+    else
+    {
+        array.pop_back();
+    }
+    return max;
 }
 
-template<typename T>
-T Heap<T>::getMax() const
+template<typename T, size_t Arity, typename Compare>
+const T& Heap<T, Arity, Compare>::getMax() const
 {
     return array[0];
 }
 
-template<typename T>
-void Heap<T>::increaseKey(size_t index,size_t value)    ///increase priority
+template<typename T, size_t Arity, typename Compare>
+void Heap<T, Arity, Compare>::increaseKey(size_t index, T value)    ///increase priority
 {
-    if(value < array[index])
+    if(comp(value, array[index]))
     {
         throw std::logic_error("value you entered is smaller than exciting priority value");
     }
-    array[index] = value;
-    while(index > 0 && array[index] > array[(index-1)/2])
-    {
-        std::swap(array[index],array[(index-1)/2]);
-        index = (index-1)/2;
-    }
+    array[index] = std::move(value);
+    siftUp(index);
 }
 
-template<typename T>
-void Heap<T>::print() const
+template<typename T, size_t Arity, typename Compare>
+void Heap<T, Arity, Compare>::reserve(size_t n)
 {
-    for(int i = 0; i < heap_size; ++i)
+    array.reserve(n);
+}
+
+template<typename T, size_t Arity, typename Compare>
+void Heap<T, Arity, Compare>::clear()
+{
+    array.clear();
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t Heap<T, Arity, Compare>::size() const
+{
+    return array.size();
+}
+
+template<typename T, size_t Arity, typename Compare>
+bool Heap<T, Arity, Compare>::isEmpty() const
+{
+    return array.empty();
+}
+
+template<typename T, size_t Arity, typename Compare>
+void Heap<T, Arity, Compare>::print() const
+{
+    for(const T& item : array)
     {
-        std::cout << array[i] << ' ';
+        std::cout << item << ' ';
     }
 
     std::cout << std::endl;
-}
\ No newline at end of file
+}
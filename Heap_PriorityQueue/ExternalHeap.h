@@ -0,0 +1,492 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "BinaryHeap.h"
+
+
+/// External-memory priority queue.
+/// Elements go into a bounded in-memory Heap; when it is full the whole heap is
+/// drained in priority order into a sorted run in an (already unlinked) temp file.
+/// extractMax takes the better of the in-memory top and the best run head, the
+/// run heads being kept in a small Heap of their own (multiway merge).
+/// All file I/O is sequential and goes through per-run buffers. Those buffers come
+/// out of the same memory budget as the heap, so the number of open runs is capped:
+/// once a spill pushes it past maxFanIn, the smaller half of the runs is merged into
+/// one new run.
+template<typename T, size_t Arity = 4, typename Compare = std::less<T>>
+class ExternalHeap
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ExternalHeap spills raw bytes, T must be trivially copyable");
+
+    private:
+        class RunFile                                   /// owns a new run's descriptor until a Run takes it over
+        {
+            private:
+                int fd{-1};
+
+            public:
+                explicit RunFile(int fd) : fd{fd} {}
+                RunFile(const RunFile&) = delete;
+                RunFile& operator=(const RunFile&) = delete;
+                ~RunFile() { if(fd >= 0) ::close(fd); }
+
+                int get() const { return fd; }
+                void release() { fd = -1; }
+        };
+
+        class Run                                       /// one sorted spill file, best element first
+        {
+            private:
+                int fd{-1};
+                uint64_t length{0};                     /// elements in the file
+                uint64_t next{0};                       /// first element not read into the buffer yet
+                std::unique_ptr<T[]> buffer;
+                size_t capacity{0};
+                size_t filled{0};
+                size_t pos{0};
+                std::unique_ptr<T[]>* scratch{nullptr};  /// shared by all runs, reads land here first
+                uint64_t* bytesRead{nullptr};
+
+                void refill(uint64_t from);             /// leaves the run untouched if the read throws
+
+            public:
+                Run(int fd, uint64_t length, size_t bufferElements, std::unique_ptr<T[]>* scratch, uint64_t* bytesRead);   /// owns fd once built
+                Run(const Run&) = delete;
+                Run& operator=(const Run&) = delete;
+                ~Run();
+
+                const T& front() const { return buffer[pos]; }
+                void pop();                             /// strong guarantee
+                bool isEmpty() const { return pos == filled && next == length; }
+                uint64_t position() const { return next - (filled - pos); }
+                uint64_t remaining() const { return length - position(); }
+                void seek(uint64_t position) { refill(position); }
+        };
+
+        struct RunHead
+        {
+            T value;
+            size_t run;
+        };
+        struct RunHeadCompare
+        {
+            Compare comp;
+            bool operator()(const RunHead& a, const RunHead& b) const { return comp(a.value, b.value); }
+        };
+
+        static constexpr size_t MIN_FAN_IN = 2;
+
+        Heap<T, Arity, Compare> memory;
+        std::vector<std::unique_ptr<Run>> runs;         /// nullptr once a run is exhausted
+        Heap<RunHead, 2, RunHeadCompare> heads;         /// best remaining element of every run
+        Compare comp;
+        size_t budget;                                  /// elements: heap, run buffers, read scratch and write buffer together
+        size_t bufferElements;                          /// per-run read buffer and spill write buffer
+        size_t maxFanIn;                                /// runs open at once; their buffers and the scratch take at most half the budget
+        size_t liveRuns{0};
+        std::unique_ptr<T[]> readScratch;               /// one more buffer: a failed read never touches a live one
+        std::string tmpDir;
+        size_t count{0};
+
+        size_t m_runsCreated{0};
+        uint64_t m_bytesSpilled{0};
+        uint64_t m_bytesRead{0};
+        uint64_t m_lostElements{0};
+
+        size_t memoryLimit() const;                     /// what the run buffers leave for the heap
+        void lose(uint64_t elements);                   /// recovery from an I/O error failed as well
+        int createRunFile();
+        void spill();
+        void mergeRuns();
+        void rebuildHeads();                            /// drops exhausted runs and renumbers the rest
+        static void writeAll(int fd, const void* data, size_t size);
+        static void readAll(int fd, uint64_t offset, void* data, size_t size, uint64_t* bytesRead);
+
+    public:
+        explicit ExternalHeap(size_t memoryBytes, std::string tmpDir = "", size_t ioBufferBytes = 1 << 16, const Compare& compare = Compare{});
+
+        ExternalHeap(const ExternalHeap&) = delete;
+        ExternalHeap& operator=(const ExternalHeap&) = delete;
+        ~ExternalHeap() = default;
+
+        void insert(T value);                           ////////////////  TC log n, plus amortized spill and merge I/O
+        const T& getMax() const;                        ////////////////  TC O(1)
+        T extractMax();                                 ////////////////  TC log n + log runs
+
+        size_t size() const;
+        bool isEmpty() const;
+        size_t runCount() const;                        /// run files created so far, merged runs included
+        size_t openRuns() const;                        /// never more than maxFanIn after an insert returns
+        uint64_t bytesSpilled() const;
+        uint64_t bytesRead() const;
+        uint64_t lostElements() const;                  /// dropped when an I/O error struck again during recovery
+};
+
+
+template<typename T, size_t Arity, typename Compare>
+ExternalHeap<T, Arity, Compare>::Run::Run(int fd, uint64_t length, size_t bufferElements, std::unique_ptr<T[]>* scratch, uint64_t* bytesRead)
+                        : fd{fd},
+                          length{length},
+                          buffer{std::make_unique_for_overwrite<T[]>(bufferElements)},
+                          capacity{bufferElements},
+                          scratch{scratch},
+                          bytesRead{bytesRead}
+{
+    refill(0);                                          ///if this throws the caller still owns fd
+}
+
+template<typename T, size_t Arity, typename Compare>
+ExternalHeap<T, Arity, Compare>::Run::~Run()
+{
+    if(fd >= 0)
+        ::close(fd);
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::Run::refill(uint64_t from)
+{
+    size_t elements = static_cast<size_t>(std::min<uint64_t>(length - from, capacity));
+    readAll(fd, from * sizeof(T), scratch->get(), elements * sizeof(T), bytesRead);
+    buffer.swap(*scratch);                              ///the old buffer is the next read's scratch
+    next = from + elements;
+    filled = elements;
+    pos = 0;
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::Run::pop()
+{
+    if(pos + 1 == filled && next != length)
+        refill(next);
+    else
+        ++pos;
+}
+
+
+template<typename T, size_t Arity, typename Compare>
+ExternalHeap<T, Arity, Compare>::ExternalHeap(size_t memoryBytes, std::string tmpDir, size_t ioBufferBytes, const Compare& compare)
+                        : memory{compare},
+                          heads{RunHeadCompare{compare}},
+                          comp{compare},
+                          budget{std::max<size_t>(memoryBytes / sizeof(T), 1)},
+                          bufferElements{std::max<size_t>(std::min(ioBufferBytes / sizeof(T), budget / (2 * (MIN_FAN_IN + 2))), 1)},
+                          maxFanIn{std::max(MIN_FAN_IN + 2, budget / 2 / bufferElements) - 2},
+                          readScratch{std::make_unique_for_overwrite<T[]>(bufferElements)},
+                          tmpDir{std::move(tmpDir)}
+{
+    if(this->tmpDir.empty())
+    {
+        const char* env = std::getenv("TMPDIR");
+        this->tmpDir = env && *env ? env : "/tmp";
+    }
+    memory.reserve(memoryLimit());
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t ExternalHeap<T, Arity, Compare>::memoryLimit() const
+{
+    size_t buffers = (liveRuns + 2) * bufferElements;   ///+2: the read scratch and the write buffer of the next spill
+    return budget > buffers ? budget - buffers : 1;
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::lose(uint64_t elements)
+{
+    count -= static_cast<size_t>(elements);
+    m_lostElements += elements;
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::writeAll(int fd, const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while(size != 0)
+    {
+        ssize_t written = ::write(fd, bytes, size);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "ExternalHeap spill write");
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::readAll(int fd, uint64_t offset, void* data, size_t size, uint64_t* bytesRead)
+{
+    char* bytes = static_cast<char*>(data);
+    while(size != 0)
+    {
+        ssize_t got = ::pread(fd, bytes, size, static_cast<off_t>(offset));
+        if(got < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "ExternalHeap run read");
+        }
+        if(got == 0)
+            throw std::runtime_error("ExternalHeap run file is truncated");
+        bytes += got;
+        offset += static_cast<uint64_t>(got);
+        size -= static_cast<size_t>(got);
+        *bytesRead += static_cast<uint64_t>(got);
+    }
+}
+
+template<typename T, size_t Arity, typename Compare>
+int ExternalHeap<T, Arity, Compare>::createRunFile()
+{
+    std::string path = tmpDir + "/extheap-XXXXXX";
+    int fd = ::mkstemp(path.data());
+    if(fd < 0)
+        throw std::system_error(errno, std::generic_category(), "ExternalHeap mkstemp");
+    ::unlink(path.c_str());                             /// the file lives as long as the descriptor
+    return fd;
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::spill()
+{
+    runs.reserve(runs.size() + 1);                      ///nothing may allocate once the heap is drained
+    heads.reserve(heads.size() + 1);
+    RunFile file{createRunFile()};
+    std::vector<T> buffer;
+    uint64_t written = 0;
+    std::unique_ptr<Run> run;
+    try
+    {
+        buffer.reserve(bufferElements);
+        while(!memory.isEmpty())                        /// draining the heap yields the run already sorted
+        {
+            buffer.push_back(memory.extractMax());
+            if(buffer.size() == bufferElements || memory.isEmpty())
+            {
+                writeAll(file.get(), buffer.data(), buffer.size() * sizeof(T));
+                written += buffer.size();
+                buffer.clear();
+            }
+        }
+        run = std::make_unique<Run>(file.get(), written, bufferElements, &readScratch, &m_bytesRead);
+        file.release();
+    }
+    catch(...)
+    {
+        memory.push_range(buffer.begin(), buffer.end());    ///put back what was drained; capacity is reserved
+        uint64_t done = 0;
+        try
+        {
+            for(; done < written; done += buffer.size())
+            {
+                buffer.resize(static_cast<size_t>(std::min<uint64_t>(written - done, bufferElements)));
+                readAll(file.get(), done * sizeof(T), buffer.data(), buffer.size() * sizeof(T), &m_bytesRead);
+                memory.push_range(buffer.begin(), buffer.end());
+            }
+        }
+        catch(...)
+        {
+            lose(written - done);
+        }
+        throw;                                          ///the original error; file closes the descriptor
+    }
+    m_bytesSpilled += written * sizeof(T);
+    ++m_runsCreated;
+
+    runs.push_back(std::move(run));
+    ++liveRuns;
+    if(!runs.back()->isEmpty())
+        heads.insert(RunHead{runs.back()->front(), runs.size() - 1});
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::mergeRuns()
+{
+    std::vector<size_t> picked;
+    for(size_t i = 0; i < runs.size(); ++i)
+    {
+        if(runs[i])
+            picked.push_back(i);
+    }
+    std::sort(picked.begin(), picked.end(), [this](size_t a, size_t b) { return runs[a]->remaining() < runs[b]->remaining(); });
+    picked.resize(std::max(MIN_FAN_IN, picked.size() / 2));   ///smallest first keeps re-merged bytes low
+
+    std::vector<uint64_t> marks;
+    for(size_t i : picked)
+        marks.push_back(runs[i]->position());
+
+    RunFile file{createRunFile()};
+    uint64_t written = 0;
+    std::unique_ptr<Run> merged;
+    try
+    {
+        Heap<RunHead, 2, RunHeadCompare> merging{RunHeadCompare{comp}};
+        for(size_t i : picked)
+            merging.insert(RunHead{runs[i]->front(), i});
+        std::vector<T> buffer;
+        buffer.reserve(bufferElements);
+        while(!merging.isEmpty())
+        {
+            RunHead head = merging.extractMax();
+            buffer.push_back(head.value);
+            Run& run = *runs[head.run];
+            run.pop();
+            if(!run.isEmpty())
+                merging.insert(RunHead{run.front(), head.run});
+            if(buffer.size() == bufferElements || merging.isEmpty())
+            {
+                writeAll(file.get(), buffer.data(), buffer.size() * sizeof(T));
+                written += buffer.size();
+                buffer.clear();
+            }
+        }
+        merged = std::make_unique<Run>(file.get(), written, bufferElements, &readScratch, &m_bytesRead);
+        file.release();
+    }
+    catch(...)
+    {
+        for(size_t k = 0; k < picked.size(); ++k)      ///the runs are still on disk, rewind them
+        {
+            Run& run = *runs[picked[k]];
+            try
+            {
+                run.seek(marks[k]);
+            }
+            catch(...)                                  ///a failed seek leaves the run where the merge left it
+            {
+                lose(run.position() - marks[k]);
+                if(run.isEmpty())
+                {
+                    runs[picked[k]].reset();
+                    --liveRuns;
+                }
+            }
+        }
+        rebuildHeads();                                 ///heads still hold the fronts from before the merge
+        throw;
+    }
+    m_bytesSpilled += written * sizeof(T);
+    ++m_runsCreated;
+
+    for(size_t i : picked)
+        runs[i].reset();
+    runs[picked.front()] = std::move(merged);
+    liveRuns -= picked.size() - 1;
+    rebuildHeads();
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::rebuildHeads()
+{
+    runs.erase(std::remove(runs.begin(), runs.end(), nullptr), runs.end());
+    heads.clear();
+    for(size_t i = 0; i < runs.size(); ++i)
+        heads.insert(RunHead{runs[i]->front(), i});
+}
+
+template<typename T, size_t Arity, typename Compare>
+void ExternalHeap<T, Arity, Compare>::insert(T value)
+{
+    if(memory.size() >= memoryLimit())
+    {
+        if(runs.size() > maxFanIn)                      ///reuse the slots of exhausted runs
+            rebuildHeads();
+        spill();
+        if(liveRuns > maxFanIn)
+            mergeRuns();
+    }
+    memory.insert(std::move(value));
+    ++count;
+}
+
+template<typename T, size_t Arity, typename Compare>
+const T& ExternalHeap<T, Arity, Compare>::getMax() const
+{
+    if(count == 0)
+        throw std::range_error("heap is empty");
+    if(heads.isEmpty() || (!memory.isEmpty() && !comp(memory.getMax(), heads.getMax().value)))
+        return memory.getMax();
+    return heads.getMax().value;
+}
+
+template<typename T, size_t Arity, typename Compare>
+T ExternalHeap<T, Arity, Compare>::extractMax()
+{
+    if(count == 0)
+        throw std::range_error("heap is empty");
+    if(heads.isEmpty() || (!memory.isEmpty() && !comp(memory.getMax(), heads.getMax().value)))
+    {
+        T top = memory.extractMax();
+        --count;
+        return top;
+    }
+
+    RunHead head = heads.getMax();
+    Run& run = *runs[head.run];
+    run.pop();                                          ///may read; nothing has changed if it throws
+    heads.extractMax();
+    if(!run.isEmpty())
+        heads.insert(RunHead{run.front(), head.run});
+    else
+    {
+        runs[head.run].reset();                         /// frees the buffer and closes the descriptor
+        --liveRuns;
+    }
+    --count;
+    return head.value;
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t ExternalHeap<T, Arity, Compare>::size() const
+{
+    return count;
+}
+
+template<typename T, size_t Arity, typename Compare>
+bool ExternalHeap<T, Arity, Compare>::isEmpty() const
+{
+    return count == 0;
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t ExternalHeap<T, Arity, Compare>::runCount() const
+{
+    return m_runsCreated;
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t ExternalHeap<T, Arity, Compare>::openRuns() const
+{
+    return liveRuns;
+}
+
+template<typename T, size_t Arity, typename Compare>
+uint64_t ExternalHeap<T, Arity, Compare>::bytesSpilled() const
+{
+    return m_bytesSpilled;
+}
+
+template<typename T, size_t Arity, typename Compare>
+uint64_t ExternalHeap<T, Arity, Compare>::bytesRead() const
+{
+    return m_bytesRead;
+}
+
+template<typename T, size_t Arity, typename Compare>
+uint64_t ExternalHeap<T, Arity, Compare>::lostElements() const
+{
+    return m_lostElements;
+}
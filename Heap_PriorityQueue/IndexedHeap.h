@@ -0,0 +1,256 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+
+/// Addressable priority queue - push hands out a handle that stays valid until
+/// the element leaves the heap, so priorities can be changed or elements erased
+/// without knowing where they currently sit in the array.
+/// Compare = std::less gives a max-heap like Heap, std::greater a min-heap.
+template<typename T, size_t Arity = 2, typename Compare = std::less<T>>
+class IndexedHeap
+{
+    static_assert(Arity >= 2, "IndexedHeap arity must be at least 2");
+
+    private:
+        static constexpr size_t NPOS = SIZE_MAX;
+
+        struct Entry
+        {
+            T value;
+            size_t handle;
+        };
+
+        std::vector<Entry> array;
+        std::vector<size_t> position;                   /// handle -> index in array, NPOS when free
+        std::vector<size_t> freeHandles;
+        Compare comp;
+
+        static size_t parent(size_t index) { return (index - 1) / Arity; }
+        static size_t firstChild(size_t index) { return Arity * index + 1; }
+
+        void validHandle(size_t handle) const;
+        void place(size_t index, Entry&& entry);
+        void siftUp(size_t index);
+        void siftDown(size_t index);
+        void removeAt(size_t index);
+
+    public:
+        IndexedHeap() = default;
+        explicit IndexedHeap(const Compare& compare) : comp{compare} {}
+
+        IndexedHeap(const IndexedHeap& src) = default;
+        IndexedHeap& operator=(const IndexedHeap& rhs) = default;
+        IndexedHeap(IndexedHeap&& src) noexcept = default;
+        IndexedHeap& operator=(IndexedHeap&& rhs) noexcept = default;
+        ~IndexedHeap() = default;
+
+        size_t push(T value);                           ////////////////  TC log n
+        void update(size_t handle, T value);            ////////////////  TC log n, either direction
+        void erase(size_t handle);                      ////////////////  TC log n
+        bool contains(size_t handle) const;             ////////////////  TC O(1)
+        const T& get(size_t handle) const;              ////////////////  TC O(1)
+
+        const T& getMax() const;                        ////////////////  TC O(1)
+        size_t topHandle() const;                       ////////////////  TC O(1)
+        T extractMax();                                 ////////////////  TC log n
+
+        void reserve(size_t n);
+        void clear();
+        size_t size() const;
+        bool isEmpty() const;
+        void print() const;
+};
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::validHandle(size_t handle) const
+{
+    if(!contains(handle))
+        throw std::out_of_range("handle is not in the heap");
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::place(size_t index, Entry&& entry)
+{
+    position[entry.handle] = index;
+    array[index] = std::move(entry);
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::siftUp(size_t index)      ///moves a hole up instead of swapping
+{
+    Entry entry = std::move(array[index]);
+    while(index != 0 && comp(array[parent(index)].value, entry.value))
+    {
+        place(index, std::move(array[parent(index)]));
+        index = parent(index);
+    }
+    place(index, std::move(entry));
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::siftDown(size_t index)
+{
+    const size_t n = array.size();
+    Entry entry = std::move(array[index]);
+    while(true)
+    {
+        size_t first = firstChild(index);
+        if(first >= n)
+            break;
+        size_t last = first + Arity < n ? first + Arity : n;
+        size_t best = first;
+        for(size_t child = first + 1; child < last; ++child)
+        {
+            if(comp(array[best].value, array[child].value))
+                best = child;
+        }
+        if(!comp(entry.value, array[best].value))
+            break;
+        place(index, std::move(array[best]));
+        index = best;
+    }
+    place(index, std::move(entry));
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::removeAt(size_t index)
+{
+    position[array[index].handle] = NPOS;
+    freeHandles.push_back(array[index].handle);
+    if(index + 1 != array.size())
+    {
+        array[index] = std::move(array.back());
+        array.pop_back();
+        position[array[index].handle] = index;
+        if(index != 0 && comp(array[parent(index)].value, array[index].value))
+            siftUp(index);
+        else
+            siftDown(index);
+    }
+    else
+    {
+        array.pop_back();
+    }
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t IndexedHeap<T, Arity, Compare>::push(T value)
+{
+    size_t handle;
+    if(!freeHandles.empty())
+    {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+    else
+    {
+        handle = position.size();
+        position.push_back(NPOS);
+    }
+    array.push_back(Entry{std::move(value), handle});
+    position[handle] = array.size() - 1;
+    siftUp(array.size() - 1);
+    return handle;
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::update(size_t handle, T value)
+{
+    validHandle(handle);
+    size_t index = position[handle];
+    bool up = comp(array[index].value, value);
+    array[index].value = std::move(value);
+    if(up)
+        siftUp(index);
+    else
+        siftDown(index);
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::erase(size_t handle)
+{
+    validHandle(handle);
+    removeAt(position[handle]);
+}
+
+template<typename T, size_t Arity, typename Compare>
+bool IndexedHeap<T, Arity, Compare>::contains(size_t handle) const
+{
+    return handle < position.size() && position[handle] != NPOS;
+}
+
+template<typename T, size_t Arity, typename Compare>
+const T& IndexedHeap<T, Arity, Compare>::get(size_t handle) const
+{
+    validHandle(handle);
+    return array[position[handle]].value;
+}
+
+template<typename T, size_t Arity, typename Compare>
+const T& IndexedHeap<T, Arity, Compare>::getMax() const
+{
+    if(array.empty())
+        throw std::range_error("heap is empty");
+    return array[0].value;
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t IndexedHeap<T, Arity, Compare>::topHandle() const
+{
+    if(array.empty())
+        throw std::range_error("heap is empty");
+    return array[0].handle;
+}
+
+template<typename T, size_t Arity, typename Compare>
+T IndexedHeap<T, Arity, Compare>::extractMax()
+{
+    if(array.empty())
+        throw std::range_error("heap is empty");
+    T max = std::move(array[0].value);
+    removeAt(0);
+    return max;
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::reserve(size_t n)
+{
+    array.reserve(n);
+    position.reserve(n);
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::clear()
+{
+    array.clear();
+    position.clear();
+    freeHandles.clear();
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t IndexedHeap<T, Arity, Compare>::size() const
+{
+    return array.size();
+}
+
+template<typename T, size_t Arity, typename Compare>
+bool IndexedHeap<T, Arity, Compare>::isEmpty() const
+{
+    return array.empty();
+}
+
+template<typename T, size_t Arity, typename Compare>
+void IndexedHeap<T, Arity, Compare>::print() const
+{
+    for(const Entry& entry : array)
+    {
+        std::cout << entry.value << ' ';
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include "BinaryHeap.h"
+
+
+/// Concurrent relaxed priority queue (MultiQueue).
+/// c*P sequential Heap shards, each behind its own lock. insert goes to a random
+/// shard, extractMax samples `choices` random shards and pops the best of their tops.
+/// There is no global lock; the price is that extractMax returns one of the top
+/// O(c*P) elements rather than exactly the top one. More shards per thread means
+/// less contention and looser order, more choices means tighter order.
+template<typename T, size_t Arity = 4, typename Compare = std::less<T>>
+class MultiQueue
+{
+    private:
+        struct alignas(64) Shard
+        {
+            std::mutex lock;
+            Heap<T, Arity, Compare> heap;
+            std::atomic<size_t> count{0};               /// lets callers skip empty shards without locking
+        };
+
+        static constexpr size_t MAX_CHOICES = 8;
+
+        std::unique_ptr<Shard[]> shards;
+        size_t shardCount;
+        size_t choices;
+        Compare comp;
+
+        static uint64_t nextRandom();                   /// per thread xorshift
+        size_t randomShard() const { return nextRandom() % shardCount; }
+        std::optional<T> popFromAny();                  /// slow path, locks every shard in turn
+
+    public:
+        explicit MultiQueue(size_t threads, size_t shardsPerThread = 2, size_t choices = 2, const Compare& compare = Compare{});
+
+        MultiQueue(const MultiQueue&) = delete;
+        MultiQueue& operator=(const MultiQueue&) = delete;
+        ~MultiQueue() = default;
+
+        void insert(T value);                           ////////////////  TC log(n / shards)
+        std::optional<T> extractMax();                  ////////////////  TC log(n / shards), nullopt when empty
+        size_t size() const;                            /// racy snapshot
+        bool isEmpty() const;                           /// racy snapshot
+        size_t shardsCount() const;
+};
+
+template<typename T, size_t Arity, typename Compare>
+MultiQueue<T, Arity, Compare>::MultiQueue(size_t threads, size_t shardsPerThread, size_t choices, const Compare& compare)
+                        : shardCount{std::max<size_t>(threads * shardsPerThread, 2)},
+                          choices{choices},
+                          comp{compare}
+{
+    if(choices < 1 || choices > MAX_CHOICES)
+        throw std::invalid_argument("MultiQueue choices must be between 1 and 8");
+    shards.reset(new Shard[shardCount]);
+}
+
+template<typename T, size_t Arity, typename Compare>
+uint64_t MultiQueue<T, Arity, Compare>::nextRandom()
+{
+    thread_local uint64_t state = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+template<typename T, size_t Arity, typename Compare>
+void MultiQueue<T, Arity, Compare>::insert(T value)
+{
+    Shard* shard = &shards[randomShard()];
+    for(size_t attempt = 0; !shard->lock.try_lock(); ++attempt)     ///busy shard - go elsewhere rather than wait
+    {
+        shard = &shards[randomShard()];
+        if(attempt == shardCount)
+        {
+            shard->lock.lock();
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> guard{shard->lock, std::adopt_lock};
+    shard->heap.insert(std::move(value));
+    shard->count.store(shard->heap.size(), std::memory_order_relaxed);
+}
+
+template<typename T, size_t Arity, typename Compare>
+std::optional<T> MultiQueue<T, Arity, Compare>::extractMax()
+{
+    for(size_t round = 0; round < shardCount; ++round)
+    {
+        Shard* locked[MAX_CHOICES];
+        size_t held = 0;
+        for(size_t i = 0; i < choices; ++i)
+        {
+            Shard* shard = &shards[randomShard()];
+            if(shard->count.load(std::memory_order_relaxed) == 0)
+                continue;
+            bool duplicate = false;
+            for(size_t j = 0; j < held; ++j)
+                duplicate = duplicate || locked[j] == shard;
+            if(!duplicate && shard->lock.try_lock())
+                locked[held++] = shard;
+        }
+
+        Shard* best = nullptr;
+        for(size_t i = 0; i < held; ++i)
+        {
+            if(locked[i]->heap.isEmpty())
+                continue;
+            if(!best || comp(best->heap.getMax(), locked[i]->heap.getMax()))
+                best = locked[i];
+        }
+
+        std::optional<T> result;
+        if(best)
+        {
+            result = best->heap.extractMax();
+            best->count.store(best->heap.size(), std::memory_order_relaxed);
+        }
+        for(size_t i = 0; i < held; ++i)
+            locked[i]->lock.unlock();
+        if(result)
+            return result;
+    }
+    return popFromAny();
+}
+
+template<typename T, size_t Arity, typename Compare>
+std::optional<T> MultiQueue<T, Arity, Compare>::popFromAny()
+{
+    for(size_t i = 0; i < shardCount; ++i)
+    {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> guard{shard.lock};
+        if(shard.heap.isEmpty())
+            continue;
+        T value = shard.heap.extractMax();
+        shard.count.store(shard.heap.size(), std::memory_order_relaxed);
+        return value;
+    }
+    return std::nullopt;
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t MultiQueue<T, Arity, Compare>::size() const
+{
+    size_t total = 0;
+    for(size_t i = 0; i < shardCount; ++i)
+        total += shards[i].count.load(std::memory_order_relaxed);
+    return total;
+}
+
+template<typename T, size_t Arity, typename Compare>
+bool MultiQueue<T, Arity, Compare>::isEmpty() const
+{
+    return size() == 0;
+}
+
+template<typename T, size_t Arity, typename Compare>
+size_t MultiQueue<T, Arity, Compare>::shardsCount() const
+{
+    return shardCount;
+}
@@ -0,0 +1,448 @@
+#pragma once
+#include <iostream>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+
+/// Meldable priority queue - pairing heap with the same operations as Heap plus O(1) meld.
+/// Nodes come from a per-heap slab pool; meld splices the other heap's slabs into this
+/// one, so handles taken from either heap stay valid afterwards.
+template<typename T, typename Compare = std::less<T>>
+class PairingHeap
+{
+    private:
+        class Node
+        {
+            public:
+                T value;
+                Node* child{nullptr};                   /// leftmost child
+                Node* sibling{nullptr};                 /// next sibling to the right
+                Node* prev{nullptr};                    /// left sibling, or parent for the leftmost child
+                template<typename... Args>
+                Node(Args&&... args) : value{std::forward<Args>(args)...} {};
+        };
+
+        class NodePool
+        {
+            private:
+                static constexpr size_t SLAB_NODES = sizeof(Node) < 256 ? 16384 / sizeof(Node) : 64;
+
+                union Slot
+                {
+                    Slot* next;
+                    alignas(Node) unsigned char storage[sizeof(Node)];
+                };
+                struct Slab
+                {
+                    Slab* next{nullptr};
+                    Slot slots[SLAB_NODES];
+                };
+
+                Slab* slabs{nullptr};
+                Slab* lastSlab{nullptr};
+                Slab* current{nullptr};                 /// slab handed out by bump allocation
+                size_t used{0};
+                Slot* freeList{nullptr};
+                Slot* lastFree{nullptr};
+
+                void release();
+
+            public:
+                NodePool() = default;
+                NodePool(const NodePool&) = delete;
+                NodePool& operator=(const NodePool&) = delete;
+                NodePool(NodePool&& src) noexcept;
+                NodePool& operator=(NodePool&& rhs) noexcept;
+                ~NodePool();
+
+                template<typename... Args>
+                Node* create(Args&&... args);
+                void destroy(Node* node);
+                void splice(NodePool& other);           /// takes over other's memory in O(1)
+        };
+
+        Node* root{nullptr};
+        size_t count{0};
+        NodePool pool;
+        Compare comp;
+
+        Node* link(Node* a, Node* b);                   /// winner adopts loser as leftmost child
+        Node* combineSiblings(Node* first);             /// iterative two-pass pairing
+        void cut(Node* node);
+        void destroyAll();
+
+    public:
+        class Handle
+        {
+            friend class PairingHeap;
+            Node* node{nullptr};
+            explicit Handle(Node* n) : node{n} {}
+            public:
+                Handle() = default;
+                const T& value() const { return node->value; }
+        };
+
+        PairingHeap() = default;
+        explicit PairingHeap(const Compare& compare) : comp{compare} {}
+        PairingHeap(const std::initializer_list<T>& list);
+
+        PairingHeap(const PairingHeap& src) = delete;   /// handles point at nodes, a copy would not honour them
+        PairingHeap& operator=(const PairingHeap& rhs) = delete;
+        PairingHeap(PairingHeap&& src) noexcept;
+        PairingHeap& operator=(PairingHeap&& rhs) noexcept;
+        ~PairingHeap();
+
+        Handle insert(T value);                         ////////////////  TC O(1)
+        template<typename... Args>
+        Handle emplace(Args&&... args);                 ////////////////  TC O(1)
+        const T& getMax() const;                        ////////////////  TC O(1)
+        T extractMax();                                 ////////////////  TC log n amortized
+        void increaseKey(Handle handle, T value);       ////////////////  TC o(log n) amortized
+        void meld(PairingHeap&& other);                 ////////////////  TC O(1)
+
+        void clear();
+        size_t size() const;
+        bool isEmpty() const;
+};
+
+
+template<typename T, typename Compare>
+PairingHeap<T, Compare>::NodePool::NodePool(NodePool&& src) noexcept
+                    : slabs{std::exchange(src.slabs, nullptr)},
+                      lastSlab{std::exchange(src.lastSlab, nullptr)},
+                      current{std::exchange(src.current, nullptr)},
+                      used{std::exchange(src.used, 0)},
+                      freeList{std::exchange(src.freeList, nullptr)},
+                      lastFree{std::exchange(src.lastFree, nullptr)}
+{}
+
+template<typename T, typename Compare>
+typename PairingHeap<T, Compare>::NodePool& PairingHeap<T, Compare>::NodePool::operator=(NodePool&& rhs) noexcept
+{
+    if(&rhs == this)
+        return *this;
+    release();
+    slabs = std::exchange(rhs.slabs, nullptr);
+    lastSlab = std::exchange(rhs.lastSlab, nullptr);
+    current = std::exchange(rhs.current, nullptr);
+    used = std::exchange(rhs.used, 0);
+    freeList = std::exchange(rhs.freeList, nullptr);
+    lastFree = std::exchange(rhs.lastFree, nullptr);
+    return *this;
+}
+
+template<typename T, typename Compare>
+PairingHeap<T, Compare>::NodePool::~NodePool()
+{
+    release();
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::NodePool::release()
+{
+    while(slabs)
+    {
+        Slab* next = slabs->next;
+        delete slabs;
+        slabs = next;
+    }
+    lastSlab = current = nullptr;
+    freeList = lastFree = nullptr;
+    used = 0;
+}
+
+template<typename T, typename Compare>
+template<typename... Args>
+typename PairingHeap<T, Compare>::Node* PairingHeap<T, Compare>::NodePool::create(Args&&... args)
+{
+    Slot* slot;
+    if(freeList)
+    {
+        slot = freeList;
+        freeList = freeList->next;
+        if(!freeList)
+            lastFree = nullptr;
+    }
+    else
+    {
+        if(!current || used == SLAB_NODES)
+        {
+            Slab* slab = new Slab;
+            if(lastSlab)
+                lastSlab->next = slab;
+            else
+                slabs = slab;
+            lastSlab = slab;
+            current = slab;
+            used = 0;
+        }
+        slot = &current->slots[used++];
+    }
+    try
+    {
+        return new (slot->storage) Node(std::forward<Args>(args)...);
+    }
+    catch(...)
+    {
+        slot->next = freeList;
+        freeList = slot;
+        if(!lastFree)
+            lastFree = slot;
+        throw;
+    }
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::NodePool::destroy(Node* node)
+{
+    node->~Node();
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->next = freeList;
+    freeList = slot;
+    if(!lastFree)
+        lastFree = slot;
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::NodePool::splice(NodePool& other)
+{
+    if(other.slabs)
+    {
+        if(lastSlab)
+            lastSlab->next = other.slabs;
+        else
+            slabs = other.slabs;
+        lastSlab = other.lastSlab;
+    }
+    if(other.freeList)
+    {
+        if(lastFree)
+            lastFree->next = other.freeList;
+        else
+            freeList = other.freeList;
+        lastFree = other.lastFree;
+    }
+    if(!current)                                        /// otherwise the rest of other's bump slab stays unused
+    {
+        current = other.current;
+        used = other.used;
+    }
+    other.slabs = other.lastSlab = other.current = nullptr;
+    other.freeList = other.lastFree = nullptr;
+    other.used = 0;
+}
+
+
+template<typename T, typename Compare>
+PairingHeap<T, Compare>::PairingHeap(const std::initializer_list<T>& list)
+{
+    for(const T& item : list)
+    {
+        insert(item);
+    }
+}
+
+template<typename T, typename Compare>
+PairingHeap<T, Compare>::PairingHeap(PairingHeap&& src) noexcept
+                    : root{std::exchange(src.root, nullptr)},
+                      count{std::exchange(src.count, 0)},
+                      pool{std::move(src.pool)},
+                      comp{src.comp}
+{}
+
+template<typename T, typename Compare>
+PairingHeap<T, Compare>& PairingHeap<T, Compare>::operator=(PairingHeap&& rhs) noexcept
+{
+    if(&rhs == this)
+        return *this;
+    destroyAll();
+    root = std::exchange(rhs.root, nullptr);
+    count = std::exchange(rhs.count, 0);
+    pool = std::move(rhs.pool);
+    comp = rhs.comp;
+    return *this;
+}
+
+template<typename T, typename Compare>
+PairingHeap<T, Compare>::~PairingHeap()
+{
+    destroyAll();
+}
+
+template<typename T, typename Compare>
+typename PairingHeap<T, Compare>::Node* PairingHeap<T, Compare>::link(Node* a, Node* b)
+{
+    if(!a)
+        return b;
+    if(!b)
+        return a;
+    if(comp(a->value, b->value))
+        std::swap(a, b);
+    b->prev = a;
+    b->sibling = a->child;
+    if(a->child)
+        a->child->prev = b;
+    a->child = b;
+    a->sibling = nullptr;
+    a->prev = nullptr;
+    return a;
+}
+
+template<typename T, typename Compare>
+typename PairingHeap<T, Compare>::Node* PairingHeap<T, Compare>::combineSiblings(Node* first)
+{
+    if(!first)
+        return nullptr;
+
+    /// first pass - link neighbours left to right, stacking the winners through sibling
+    Node* pairs = nullptr;
+    while(first)
+    {
+        Node* a = first;
+        Node* b = a->sibling;
+        if(!b)
+        {
+            a->prev = nullptr;
+            a->sibling = pairs;
+            pairs = a;
+            break;
+        }
+        first = b->sibling;
+        a->sibling = b->sibling = nullptr;
+        Node* winner = link(a, b);
+        winner->sibling = pairs;
+        pairs = winner;
+    }
+
+    /// second pass - fold the stack, i.e. right to left
+    Node* result = pairs;
+    pairs = pairs->sibling;
+    result->sibling = nullptr;
+    while(pairs)
+    {
+        Node* next = pairs->sibling;
+        pairs->sibling = nullptr;
+        result = link(result, pairs);
+        pairs = next;
+    }
+    return result;
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::cut(Node* node)
+{
+    if(node->prev->child == node)
+        node->prev->child = node->sibling;
+    else
+        node->prev->sibling = node->sibling;
+    if(node->sibling)
+        node->sibling->prev = node->prev;
+    node->sibling = nullptr;
+    node->prev = nullptr;
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::destroyAll()                             /// iterative, the tree can be a long chain
+{
+    Node* stack = root;                                                 /// pending nodes chained through sibling
+    while(stack)
+    {
+        Node* node = stack;
+        stack = node->sibling;
+        if(node->child)
+        {
+            Node* last = node->child;
+            while(last->sibling)
+                last = last->sibling;
+            last->sibling = stack;
+            stack = node->child;
+        }
+        pool.destroy(node);
+    }
+    root = nullptr;
+    count = 0;
+}
+
+template<typename T, typename Compare>
+typename PairingHeap<T, Compare>::Handle PairingHeap<T, Compare>::insert(T value)
+{
+    return emplace(std::move(value));
+}
+
+template<typename T, typename Compare>
+template<typename... Args>
+typename PairingHeap<T, Compare>::Handle PairingHeap<T, Compare>::emplace(Args&&... args)
+{
+    Node* node = pool.create(std::forward<Args>(args)...);
+    root = link(root, node);
+    ++count;
+    return Handle{node};
+}
+
+template<typename T, typename Compare>
+const T& PairingHeap<T, Compare>::getMax() const
+{
+    if(!root)
+        throw std::range_error("heap is empty");
+    return root->value;
+}
+
+template<typename T, typename Compare>
+T PairingHeap<T, Compare>::extractMax()
+{
+    if(!root)
+        throw std::range_error("heap is empty");
+    Node* old = root;
+    T max = std::move(old->value);
+    root = combineSiblings(old->child);
+    pool.destroy(old);
+    --count;
+    return max;
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::increaseKey(Handle handle, T value)     ///increase priority
+{
+    Node* node = handle.node;
+    if(comp(value, node->value))
+    {
+        throw std::logic_error("value you entered is smaller than exciting priority value");
+    }
+    node->value = std::move(value);
+    if(node != root)
+    {
+        cut(node);
+        root = link(root, node);
+    }
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::meld(PairingHeap&& other)
+{
+    if(&other == this)
+        return;
+    pool.splice(other.pool);
+    root = link(root, std::exchange(other.root, nullptr));
+    count += std::exchange(other.count, 0);
+}
+
+template<typename T, typename Compare>
+void PairingHeap<T, Compare>::clear()
+{
+    destroyAll();
+}
+
+template<typename T, typename Compare>
+size_t PairingHeap<T, Compare>::size() const
+{
+    return count;
+}
+
+template<typename T, typename Compare>
+bool PairingHeap<T, Compare>::isEmpty() const
+{
+    return count == 0;
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/// Monotone radix heap - MINHEAP for unsigned integer keys where an inserted key is
+/// never smaller than the last extracted one (Dijkstra, event simulation).
+/// Bucket i holds keys whose highest bit differing from the last extracted key is
+/// bit i-1, so there are digits+1 buckets and every element moves down at most that
+/// many times over its life: push is O(1), extractMin O(log C) amortized, and no
+/// element is ever compared against the rest of the heap.
+template<typename Key, typename Value>
+class RadixHeap
+{
+    static_assert(std::is_unsigned_v<Key>, "RadixHeap keys must be unsigned integers");
+
+    private:
+        static constexpr size_t BUCKETS = std::numeric_limits<Key>::digits + 1;
+
+        std::array<std::vector<std::pair<Key, Value>>, BUCKETS> buckets;
+        Key last{0};                                    /// last extracted key, lower bound for inserts
+        size_t count{0};
+
+        static size_t bucketIndex(Key key, Key last) { return key == last ? 0 : std::bit_width(static_cast<Key>(key ^ last)); }
+        void pull();                                    /// refills bucket 0 from the first non-empty bucket
+
+    public:
+        RadixHeap() = default;
+        RadixHeap(const RadixHeap& src) = default;
+        RadixHeap& operator=(const RadixHeap& rhs) = default;
+        RadixHeap(RadixHeap&& src) noexcept = default;
+        RadixHeap& operator=(RadixHeap&& rhs) noexcept = default;
+        ~RadixHeap() = default;
+
+        void insert(Key key, Value value);              ////////////////  TC O(1)
+        const std::pair<Key, Value>& getMin();          ////////////////  TC O(log C) amortized
+        std::pair<Key, Value> extractMin();             ////////////////  TC O(log C) amortized
+        Key lastKey() const;
+
+        void clear();
+        size_t size() const;
+        bool isEmpty() const;
+};
+
+template<typename Key, typename Value>
+void RadixHeap<Key, Value>::insert(Key key, Value value)
+{
+    if(key < last)
+    {
+        throw std::logic_error("key is smaller than the last extracted key");
+    }
+    buckets[bucketIndex(key, last)].emplace_back(key, std::move(value));
+    ++count;
+}
+
+template<typename Key, typename Value>
+void RadixHeap<Key, Value>::pull()
+{
+    if(!buckets[0].empty())
+        return;
+
+    size_t i = 1;
+    while(buckets[i].empty())
+        ++i;
+
+    Key newLast = buckets[i][0].first;
+    for(const auto& item : buckets[i])
+    {
+        if(item.first < newLast)
+            newLast = item.first;
+    }
+    /// every key of bucket i now agrees with newLast above bit i-1, so each lands in a lower bucket
+    last = newLast;
+    for(auto& item : buckets[i])
+    {
+        buckets[bucketIndex(item.first, last)].push_back(std::move(item));
+    }
+    buckets[i].clear();
+}
+
+template<typename Key, typename Value>
+const std::pair<Key, Value>& RadixHeap<Key, Value>::getMin()
+{
+    if(count == 0)
+        throw std::range_error("heap is empty");
+    pull();
+    return buckets[0].back();
+}
+
+template<typename Key, typename Value>
+std::pair<Key, Value> RadixHeap<Key, Value>::extractMin()
+{
+    if(count == 0)
+        throw std::range_error("heap is empty");
+    pull();
+    std::pair<Key, Value> min = std::move(buckets[0].back());
+    buckets[0].pop_back();
+    --count;
+    return min;
+}
+
+template<typename Key, typename Value>
+Key RadixHeap<Key, Value>::lastKey() const
+{
+    return last;
+}
+
+template<typename Key, typename Value>
+void RadixHeap<Key, Value>::clear()
+{
+    for(auto& bucket : buckets)
+        bucket.clear();
+    last = 0;
+    count = 0;
+}
+
+template<typename Key, typename Value>
+size_t RadixHeap<Key, Value>::size() const
+{
+    return count;
+}
+
+template<typename Key, typename Value>
+bool RadixHeap<Key, Value>::isEmpty() const
+{
+    return count == 0;
+}
@@ -0,0 +1,335 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "BinaryHeap.h"
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SIMD_HEAP_X86 1
+#endif
+
+
+/// 16-ary heap for 32-bit arithmetic keys (int32_t, uint32_t, float).
+/// A sibling group is exactly one 64-byte cache line, and the best child of a group
+/// is found with one vector compare and a horizontal reduction instead of 15
+/// data-dependent branches. The kernel (AVX-512F, AVX2 or scalar) is picked at run
+/// time from the CPU. Unused slots of the last group hold the worst possible key
+/// (an infinity for float), so kernels always read whole lines. Compare is
+/// std::less (max-heap) or std::greater (min-heap); NaN keys are not supported.
+template<typename T, typename Compare = std::less<T>>
+class SimdHeap
+{
+    static_assert(std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> || std::is_same_v<T, float>,
+                  "SimdHeap keys must be int32_t, uint32_t or float");
+    static_assert(std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::greater<T>>,
+                  "SimdHeap supports std::less (max-heap) and std::greater (min-heap)");
+
+    private:
+        static constexpr size_t Arity = 16;
+        static constexpr bool MAX = std::is_same_v<Compare, std::less<T>>;
+        static constexpr T SENTINEL = std::numeric_limits<T>::has_infinity       /// float: -inf/+inf, no real key ranks below it
+            ? (MAX ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity())
+            : (MAX ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max());
+
+        using ChildKernel = unsigned (*)(const T* children);
+
+        std::vector<T, SiblingAlignedAllocator<T>> array;   /// element 1 is line aligned, so is every sibling group
+        size_t heap_size{0};
+        ChildKernel bestChild;
+        const char* kernelName;
+
+        static size_t parent(size_t index) { return (index - 1) / Arity; }
+        static size_t firstChild(size_t index) { return Arity * index + 1; }
+
+        static unsigned bestChildScalar(const T* children);
+#ifdef SIMD_HEAP_X86
+        __attribute__((target("avx2"))) static unsigned bestChildAvx2(const T* children);
+        __attribute__((target("avx512f"))) static unsigned bestChildAvx512(const T* children);
+#endif
+        void selectKernel();
+        void siftUp(size_t index);
+        void siftDown(size_t index);
+
+    public:
+        SimdHeap();
+        SimdHeap(const std::initializer_list<T>& list);
+
+        SimdHeap(const SimdHeap& src) = default;
+        SimdHeap& operator=(const SimdHeap& rhs) = default;
+        SimdHeap(SimdHeap&& src) = default;
+        SimdHeap& operator=(SimdHeap&& rhs) = default;
+        ~SimdHeap() = default;
+
+        void insert(T value);                           ////////////////  TC log16 n
+        T extractMax();                                 ////////////////  TC log16 n vector steps
+        T getMax() const;                               ////////////////  TC O(1)
+        void reserve(size_t n);
+        size_t size() const;
+        bool isEmpty() const;
+        const char* kernel() const;                     /// "avx512f", "avx2" or "scalar"
+        void print() const;
+};
+
+template<typename T, typename Compare>
+SimdHeap<T, Compare>::SimdHeap()
+{
+    selectKernel();
+}
+
+template<typename T, typename Compare>
+SimdHeap<T, Compare>::SimdHeap(const std::initializer_list<T>& list)
+{
+    selectKernel();
+    reserve(list.size());
+    for(const T& item : list)
+    {
+        insert(item);
+    }
+}
+
+template<typename T, typename Compare>
+void SimdHeap<T, Compare>::selectKernel()
+{
+    bestChild = bestChildScalar;
+    kernelName = "scalar";
+#ifdef SIMD_HEAP_X86
+    if(__builtin_cpu_supports("avx512f"))
+    {
+        bestChild = bestChildAvx512;
+        kernelName = "avx512f";
+    }
+    else if(__builtin_cpu_supports("avx2"))
+    {
+        bestChild = bestChildAvx2;
+        kernelName = "avx2";
+    }
+#endif
+}
+
+template<typename T, typename Compare>
+unsigned SimdHeap<T, Compare>::bestChildScalar(const T* children)
+{
+    unsigned best = 0;
+    for(unsigned i = 1; i < Arity; ++i)
+    {
+        if(Compare{}(children[best], children[i]))
+            best = i;
+    }
+    return best;
+}
+
+#ifdef SIMD_HEAP_X86
+template<typename T, typename Compare>
+unsigned SimdHeap<T, Compare>::bestChildAvx2(const T* children)
+{
+    unsigned mask;
+    if constexpr(std::is_same_v<T, float>)
+    {
+        __m256 a = _mm256_loadu_ps(children);
+        __m256 b = _mm256_loadu_ps(children + 8);
+        __m256 m = MAX ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b);
+        __m128 r = MAX ? _mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1))
+                       : _mm_min_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1));
+        __m128 s = _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 0, 3, 2));
+        r = MAX ? _mm_max_ps(r, s) : _mm_min_ps(r, s);
+        s = _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 3, 0, 1));
+        r = MAX ? _mm_max_ps(r, s) : _mm_min_ps(r, s);
+        __m256 best = _mm256_broadcastss_ps(r);
+        mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, best, _CMP_EQ_OQ)))
+             | static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(b, best, _CMP_EQ_OQ))) << 8;
+    }
+    else
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(children));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(children + 8));
+        __m128i r;
+        if constexpr(std::is_same_v<T, int32_t>)
+        {
+            __m256i m = MAX ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b);
+            __m128i lo = _mm256_castsi256_si128(m);
+            __m128i hi = _mm256_extracti128_si256(m, 1);
+            r = MAX ? _mm_max_epi32(lo, hi) : _mm_min_epi32(lo, hi);
+            __m128i s = _mm_shuffle_epi32(r, _MM_SHUFFLE(1, 0, 3, 2));
+            r = MAX ? _mm_max_epi32(r, s) : _mm_min_epi32(r, s);
+            s = _mm_shuffle_epi32(r, _MM_SHUFFLE(2, 3, 0, 1));
+            r = MAX ? _mm_max_epi32(r, s) : _mm_min_epi32(r, s);
+        }
+        else
+        {
+            __m256i m = MAX ? _mm256_max_epu32(a, b) : _mm256_min_epu32(a, b);
+            __m128i lo = _mm256_castsi256_si128(m);
+            __m128i hi = _mm256_extracti128_si256(m, 1);
+            r = MAX ? _mm_max_epu32(lo, hi) : _mm_min_epu32(lo, hi);
+            __m128i s = _mm_shuffle_epi32(r, _MM_SHUFFLE(1, 0, 3, 2));
+            r = MAX ? _mm_max_epu32(r, s) : _mm_min_epu32(r, s);
+            s = _mm_shuffle_epi32(r, _MM_SHUFFLE(2, 3, 0, 1));
+            r = MAX ? _mm_max_epu32(r, s) : _mm_min_epu32(r, s);
+        }
+        __m256i best = _mm256_broadcastd_epi32(r);
+        mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, best))))
+             | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(b, best)))) << 8;
+    }
+    return static_cast<unsigned>(__builtin_ctz(mask));
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"                /// gcc's own avx512 shuffle intrinsics trip it
+#endif
+template<typename T, typename Compare>
+unsigned SimdHeap<T, Compare>::bestChildAvx512(const T* children)
+{
+    /// butterfly reduction - after four steps every lane holds the best key
+    __mmask16 mask;
+    if constexpr(std::is_same_v<T, float>)
+    {
+        __m512 v = _mm512_loadu_ps(children);
+        __m512 m = v;
+        __m512 s = _mm512_shuffle_f32x4(m, m, _MM_SHUFFLE(1, 0, 3, 2));
+        m = MAX ? _mm512_max_ps(m, s) : _mm512_min_ps(m, s);
+        s = _mm512_shuffle_f32x4(m, m, _MM_SHUFFLE(2, 3, 0, 1));
+        m = MAX ? _mm512_max_ps(m, s) : _mm512_min_ps(m, s);
+        s = _mm512_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2));
+        m = MAX ? _mm512_max_ps(m, s) : _mm512_min_ps(m, s);
+        s = _mm512_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1));
+        m = MAX ? _mm512_max_ps(m, s) : _mm512_min_ps(m, s);
+        mask = _mm512_cmp_ps_mask(v, m, _CMP_EQ_OQ);
+    }
+    else
+    {
+        __m512i v = _mm512_loadu_si512(children);
+        __m512i m = v;
+        __m512i s;
+        if constexpr(std::is_same_v<T, int32_t>)
+        {
+            s = _mm512_shuffle_i32x4(m, m, _MM_SHUFFLE(1, 0, 3, 2));
+            m = MAX ? _mm512_max_epi32(m, s) : _mm512_min_epi32(m, s);
+            s = _mm512_shuffle_i32x4(m, m, _MM_SHUFFLE(2, 3, 0, 1));
+            m = MAX ? _mm512_max_epi32(m, s) : _mm512_min_epi32(m, s);
+            s = _mm512_shuffle_epi32(m, _MM_PERM_BADC);
+            m = MAX ? _mm512_max_epi32(m, s) : _mm512_min_epi32(m, s);
+            s = _mm512_shuffle_epi32(m, _MM_PERM_CDAB);
+            m = MAX ? _mm512_max_epi32(m, s) : _mm512_min_epi32(m, s);
+        }
+        else
+        {
+            s = _mm512_shuffle_i32x4(m, m, _MM_SHUFFLE(1, 0, 3, 2));
+            m = MAX ? _mm512_max_epu32(m, s) : _mm512_min_epu32(m, s);
+            s = _mm512_shuffle_i32x4(m, m, _MM_SHUFFLE(2, 3, 0, 1));
+            m = MAX ? _mm512_max_epu32(m, s) : _mm512_min_epu32(m, s);
+            s = _mm512_shuffle_epi32(m, _MM_PERM_BADC);
+            m = MAX ? _mm512_max_epu32(m, s) : _mm512_min_epu32(m, s);
+            s = _mm512_shuffle_epi32(m, _MM_PERM_CDAB);
+            m = MAX ? _mm512_max_epu32(m, s) : _mm512_min_epu32(m, s);
+        }
+        mask = _mm512_cmpeq_epi32_mask(v, m);
+    }
+    return static_cast<unsigned>(__builtin_ctz(mask));
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+template<typename T, typename Compare>
+void SimdHeap<T, Compare>::siftUp(size_t index)
+{
+    T tmp = array[index];
+    while(index != 0 && Compare{}(array[parent(index)], tmp))
+    {
+        array[index] = array[parent(index)];
+        index = parent(index);
+    }
+    array[index] = tmp;
+}
+
+template<typename T, typename Compare>
+void SimdHeap<T, Compare>::siftDown(size_t index)
+{
+    T tmp = array[index];
+    while(true)
+    {
+        size_t first = firstChild(index);
+        if(first >= heap_size)
+            break;
+        size_t best = first + bestChild(&array[first]);    ///ties go to the lowest slot and real keys come first
+        if(best >= heap_size)                               ///never moves a key into the padding
+            break;
+        if(!Compare{}(tmp, array[best]))
+            break;
+        array[index] = array[best];
+        index = best;
+    }
+    array[index] = tmp;
+}
+
+template<typename T, typename Compare>
+void SimdHeap<T, Compare>::insert(T value)
+{
+    if(heap_size == array.size())                       ///open a new sibling group, padded with sentinels
+        array.resize(heap_size == 0 ? 1 + Arity : array.size() + Arity, SENTINEL);
+    array[heap_size] = value;
+    ++heap_size;
+    siftUp(heap_size - 1);
+}
+
+template<typename T, typename Compare>
+T SimdHeap<T, Compare>::extractMax()
+{
+    if(heap_size == 0)
+        throw std::range_error("heap is empty");
+    T max = array[0];
+    --heap_size;
+    array[0] = array[heap_size];
+    array[heap_size] = SENTINEL;
+    if(heap_size != 0)
+        siftDown(0);
+    return max;
+}
+
+template<typename T, typename Compare>
+T SimdHeap<T, Compare>::getMax() const
+{
+    if(heap_size == 0)
+        throw std::range_error("heap is empty");
+    return array[0];
+}
+
+template<typename T, typename Compare>
+void SimdHeap<T, Compare>::reserve(size_t n)
+{
+    array.reserve(n + Arity);
+}
+
+template<typename T, typename Compare>
+size_t SimdHeap<T, Compare>::size() const
+{
+    return heap_size;
+}
+
+template<typename T, typename Compare>
+bool SimdHeap<T, Compare>::isEmpty() const
+{
+    return heap_size == 0;
+}
+
+template<typename T, typename Compare>
+const char* SimdHeap<T, Compare>::kernel() const
+{
+    return kernelName;
+}
+
+template<typename T, typename Compare>
+void SimdHeap<T, Compare>::print() const
+{
+    for(size_t i = 0; i < heap_size; ++i)
+    {
+        std::cout << array[i] << ' ';
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,329 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "BinaryHeap.h"
+
+
+/// Hierarchical timing wheel - companion to Heap for timeout workloads.
+/// `levels` wheels of 2^slotBits slots each; level l has a granularity of
+/// 2^(slotBits*l) ticks. Arming and cancelling are O(1) through handles; a
+/// timer cascades down at most `levels` times before it fires. Deadlines
+/// beyond the top wheel wait in a min Heap and move into the wheel once they
+/// come in range; cancelled overflow entries are dropped lazily, and the heap is
+/// compacted once they make up more than half of it.
+template<typename T>
+class TimingWheel
+{
+    public:
+        using Handle = uint64_t;                        /// generation << 32 | timer index
+
+    private:
+        static constexpr uint32_t NIL = UINT32_MAX;
+        static constexpr uint32_t OVERFLOW_BUCKET = UINT32_MAX;
+
+        struct Timer
+        {
+            std::optional<T> payload;                   /// empty while the slot is free
+            uint64_t expiry{0};                         /// in ticks
+            uint32_t next{NIL};
+            uint32_t prev{NIL};
+            uint32_t bucket{NIL};                       /// level*slots + slot, or OVERFLOW_BUCKET
+            uint32_t generation{0};
+        };
+        struct OverflowEntry
+        {
+            uint64_t expiry;
+            uint32_t index;
+            uint32_t generation;
+        };
+        struct EarlierFirst
+        {
+            bool operator()(const OverflowEntry& a, const OverflowEntry& b) const { return a.expiry > b.expiry; }
+        };
+
+        std::vector<Timer> timers;
+        std::vector<uint32_t> freeTimers;
+        std::vector<uint32_t> buckets;                  /// list heads
+        Heap<OverflowEntry, 4, EarlierFirst> overflow;
+        uint64_t tickSize;
+        unsigned levels;
+        unsigned slotBits;
+        uint64_t slotMask;
+        uint64_t currentTick;
+        size_t wheelCount{0};                           /// timers in the wheel proper
+        size_t staleOverflow{0};                        /// cancelled entries still in overflow
+        size_t count{0};
+
+        uint32_t allocateTimer();
+        void releaseTimer(uint32_t index);
+        void link(uint32_t index, uint32_t bucket);
+        void unlink(uint32_t index);
+        void place(uint32_t index, uint64_t earliest);  /// picks the level from the distance to expiry
+        void cascade(unsigned level);
+        void pullOverflow();
+        void compactOverflow();                         /// drops cancelled entries, O(m log m)
+        template<typename F>
+        size_t expireCurrentSlot(F& onExpire);
+
+    public:
+        explicit TimingWheel(uint64_t tickSize = 1, unsigned levels = 4, unsigned slotBits = 6, uint64_t now = 0);
+
+        TimingWheel(const TimingWheel&) = default;
+        TimingWheel& operator=(const TimingWheel&) = default;
+        TimingWheel(TimingWheel&&) noexcept = default;
+        TimingWheel& operator=(TimingWheel&&) noexcept = default;
+        ~TimingWheel() = default;
+
+        Handle arm(uint64_t deadline, T payload);       ////////////////  TC O(1), O(log n) past the top wheel
+        bool cancel(Handle handle);                     ////////////////  TC O(1), amortised O(log n) past the top wheel
+        bool isArmed(Handle handle) const;
+        template<typename F>
+        size_t advance(uint64_t now, F&& onExpire);     /// fires every timer due by now, returns how many
+
+        uint64_t now() const;                           /// start of the current tick, in time units
+        size_t size() const;
+        bool isEmpty() const;
+};
+
+template<typename T>
+TimingWheel<T>::TimingWheel(uint64_t tickSize, unsigned levels, unsigned slotBits, uint64_t now)
+                        : tickSize{tickSize},
+                          levels{levels},
+                          slotBits{slotBits},
+                          slotMask{(uint64_t{1} << slotBits) - 1},
+                          currentTick{tickSize ? now / tickSize : 0}
+{
+    if(tickSize == 0 || levels == 0 || slotBits == 0 || slotBits > 16 || uint64_t{levels} * slotBits >= 64)
+        throw std::invalid_argument("invalid timing wheel geometry");
+    buckets.assign(size_t{levels} << slotBits, NIL);
+}
+
+template<typename T>
+uint32_t TimingWheel<T>::allocateTimer()
+{
+    if(!freeTimers.empty())
+    {
+        uint32_t index = freeTimers.back();
+        freeTimers.pop_back();
+        return index;
+    }
+    if(timers.size() >= NIL)
+        throw std::length_error("too many timers");
+    timers.emplace_back();
+    return static_cast<uint32_t>(timers.size() - 1);
+}
+
+template<typename T>
+void TimingWheel<T>::releaseTimer(uint32_t index)
+{
+    Timer& timer = timers[index];
+    timer.payload.reset();
+    timer.bucket = NIL;
+    ++timer.generation;                                 /// invalidates the handle and any overflow entry
+    freeTimers.push_back(index);
+    --count;
+}
+
+template<typename T>
+void TimingWheel<T>::link(uint32_t index, uint32_t bucket)
+{
+    Timer& timer = timers[index];
+    timer.bucket = bucket;
+    timer.prev = NIL;
+    timer.next = buckets[bucket];
+    if(timer.next != NIL)
+        timers[timer.next].prev = index;
+    buckets[bucket] = index;
+    ++wheelCount;
+}
+
+template<typename T>
+void TimingWheel<T>::unlink(uint32_t index)
+{
+    Timer& timer = timers[index];
+    if(timer.prev != NIL)
+        timers[timer.prev].next = timer.next;
+    else
+        buckets[timer.bucket] = timer.next;
+    if(timer.next != NIL)
+        timers[timer.next].prev = timer.prev;
+    timer.next = timer.prev = NIL;
+    --wheelCount;
+}
+
+template<typename T>
+void TimingWheel<T>::place(uint32_t index, uint64_t earliest)
+{
+    Timer& timer = timers[index];
+    if(timer.expiry < earliest)                         /// overdue - fire on the earliest slot still ahead
+        timer.expiry = earliest;
+
+    uint64_t delta = timer.expiry - currentTick;
+    for(unsigned level = 0; level < levels; ++level)
+    {
+        if(delta < uint64_t{1} << (slotBits * (level + 1)))
+        {
+            uint64_t slot = (timer.expiry >> (slotBits * level)) & slotMask;
+            link(index, static_cast<uint32_t>((level << slotBits) + slot));
+            return;
+        }
+    }
+    timer.bucket = OVERFLOW_BUCKET;
+    overflow.insert(OverflowEntry{timer.expiry, index, timer.generation});
+}
+
+template<typename T>
+void TimingWheel<T>::cascade(unsigned level)
+{
+    uint32_t bucket = static_cast<uint32_t>((level << slotBits) + ((currentTick >> (slotBits * level)) & slotMask));
+    uint32_t index = buckets[bucket];
+    buckets[bucket] = NIL;
+    while(index != NIL)
+    {
+        uint32_t next = timers[index].next;
+        --wheelCount;
+        place(index, currentTick);                      /// runs before the current slot expires
+        index = next;
+    }
+}
+
+template<typename T>
+void TimingWheel<T>::pullOverflow()
+{
+    const uint64_t horizon = currentTick + (uint64_t{1} << (slotBits * levels));
+    while(!overflow.isEmpty() && overflow.getMax().expiry < horizon)
+    {
+        OverflowEntry entry = overflow.extractMax();
+        Timer& timer = timers[entry.index];
+        if(timer.generation != entry.generation)        /// cancelled while waiting
+        {
+            --staleOverflow;
+            continue;
+        }
+        place(entry.index, currentTick);
+    }
+}
+
+template<typename T>
+void TimingWheel<T>::compactOverflow()
+{
+    std::vector<OverflowEntry> live;
+    live.reserve(overflow.size() - staleOverflow);
+    while(!overflow.isEmpty())
+    {
+        OverflowEntry entry = overflow.extractMax();
+        if(timers[entry.index].generation == entry.generation)
+            live.push_back(entry);
+    }
+    overflow.push_range(live.begin(), live.end());
+    staleOverflow = 0;
+}
+
+template<typename T>
+template<typename F>
+size_t TimingWheel<T>::expireCurrentSlot(F& onExpire)
+{
+    uint32_t bucket = static_cast<uint32_t>(currentTick & slotMask);
+    size_t fired = 0;
+    while(buckets[bucket] != NIL)                       /// re-read each time: callbacks may cancel slot mates
+    {
+        uint32_t index = buckets[bucket];
+        unlink(index);                                  /// arm never lands here, it starts at currentTick + 1
+        T payload = std::move(*timers[index].payload);
+        releaseTimer(index);
+        onExpire(std::move(payload));
+        ++fired;
+    }
+    return fired;
+}
+
+template<typename T>
+typename TimingWheel<T>::Handle TimingWheel<T>::arm(uint64_t deadline, T payload)
+{
+    uint32_t index = allocateTimer();
+    Timer& timer = timers[index];
+    timer.payload.emplace(std::move(payload));
+    timer.expiry = deadline / tickSize + (deadline % tickSize != 0);   ///round up, never fire early
+    ++count;
+    place(index, currentTick + 1);                      /// the current slot has already fired
+    return uint64_t{timers[index].generation} << 32 | index;
+}
+
+template<typename T>
+bool TimingWheel<T>::isArmed(Handle handle) const
+{
+    uint32_t index = static_cast<uint32_t>(handle);
+    return index < timers.size()
+        && timers[index].generation == static_cast<uint32_t>(handle >> 32)
+        && timers[index].payload.has_value();
+}
+
+template<typename T>
+bool TimingWheel<T>::cancel(Handle handle)
+{
+    if(!isArmed(handle))
+        return false;
+    uint32_t index = static_cast<uint32_t>(handle);
+    bool inOverflow = timers[index].bucket == OVERFLOW_BUCKET;
+    if(!inOverflow)
+        unlink(index);
+    releaseTimer(index);
+    if(inOverflow && ++staleOverflow > overflow.size() / 2)
+        compactOverflow();
+    return true;
+}
+
+template<typename T>
+template<typename F>
+size_t TimingWheel<T>::advance(uint64_t now, F&& onExpire)
+{
+    const uint64_t target = now / tickSize;
+    size_t fired = 0;
+    while(currentTick < target)
+    {
+        if(wheelCount == 0)                             /// nothing in the wheel - skip empty ticks
+        {
+            uint64_t next = target;
+            if(!overflow.isEmpty() && overflow.getMax().expiry - 1 < next)
+                next = overflow.getMax().expiry - 1;
+            if(next > currentTick)
+            {
+                currentTick = next;
+                pullOverflow();
+                continue;
+            }
+        }
+
+        ++currentTick;
+        for(unsigned level = levels - 1; level >= 1; --level)     ///top down, so cascaded timers can cascade again
+        {
+            if((currentTick & ((uint64_t{1} << (slotBits * level)) - 1)) == 0)
+                cascade(level);
+        }
+        pullOverflow();
+        fired += expireCurrentSlot(onExpire);
+    }
+    return fired;
+}
+
+template<typename T>
+uint64_t TimingWheel<T>::now() const
+{
+    return currentTick * tickSize;
+}
+
+template<typename T>
+size_t TimingWheel<T>::size() const
+{
+    return count;
+}
+
+template<typename T>
+bool TimingWheel<T>::isEmpty() const
+{
+    return count == 0;
+}
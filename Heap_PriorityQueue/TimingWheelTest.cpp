@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+#include "TimingWheel.h"
+
+/// Self-checking scenarios for TimingWheel: callbacks that cancel or re-arm timers
+/// sharing their slot, arm/cancel churn on deadlines past the top wheel, and a
+/// randomized run checked against a multimap of expiry ticks.
+///   TimingWheelTest      - exits non-zero (assert) on the first failure
+
+namespace
+{
+    using Wheel = TimingWheel<int>;
+
+    void cancelSlotMateFromCallback()
+    {
+        Wheel wheel;
+        std::vector<Wheel::Handle> handles;
+        for(int id = 0; id < 3; ++id)
+            handles.push_back(wheel.arm(10, id));
+
+        std::vector<int> fired;
+        wheel.advance(10, [&](int id)
+        {
+            fired.push_back(id);
+            for(int other = 0; other < 3; ++other)  ///whichever fires first cancels both others
+            {
+                if(other != id)
+                    wheel.cancel(handles[other]);
+            }
+        });
+        assert(fired.size() == 1);
+        assert(wheel.isEmpty());
+        for(Wheel::Handle handle : handles)
+            assert(!wheel.isArmed(handle));
+    }
+
+    void rearmFromCallback()
+    {
+        Wheel wheel;
+        Wheel::Handle keep = wheel.arm(20, 100);
+        for(int id = 0; id < 4; ++id)
+            wheel.arm(5, id);
+
+        std::vector<int> fired;
+        Wheel::Handle rearmed = 0;
+        wheel.advance(5, [&](int id)
+        {
+            fired.push_back(id);
+            if(id == 0)
+                rearmed = wheel.arm(5, 50);             ///already due: goes to the next tick
+        });
+        assert(fired.size() == 4);
+        assert(wheel.isArmed(rearmed) && wheel.isArmed(keep));
+        assert(wheel.size() == 2);
+
+        fired.clear();
+        wheel.advance(6, [&](int id) { fired.push_back(id); });
+        assert(fired.size() == 1 && fired[0] == 50);
+
+        fired.clear();
+        wheel.advance(30, [&](int id)
+        {
+            fired.push_back(id);
+            assert(!wheel.cancel(keep));                ///already released before its callback
+        });
+        assert(fired.size() == 1 && fired[0] == 100 && wheel.isEmpty());
+    }
+
+    void overflowChurn()
+    {
+        Wheel wheel(1, 2, 4);                           ///256 ticks of wheel, the rest overflows
+        Wheel::Handle live = wheel.arm(1'000'000, -1);
+        for(int round = 0; round < 100'000; ++round)
+            assert(wheel.cancel(wheel.arm(500'000 + round, round)));
+        assert(wheel.size() == 1);
+
+        std::vector<int> fired;
+        wheel.advance(2'000'000, [&](int id) { fired.push_back(id); });
+        assert(fired.size() == 1 && fired[0] == -1 && !wheel.isArmed(live));
+    }
+
+    void randomAgainstMultimap(uint64_t tick, unsigned levels, unsigned slotBits, uint64_t seed)
+    {
+        struct Armed
+        {
+            Wheel::Handle handle;
+            std::multimap<uint64_t, int>::iterator due;
+        };
+        Wheel wheel(tick, levels, slotBits, 5);
+        std::multimap<uint64_t, int> dueTicks;          ///expiry tick -> id, the reference
+        std::map<int, Armed> armed;
+        std::mt19937_64 rng(seed);
+        int nextId = 0;
+        uint64_t now = 5;
+
+        auto arm = [&](uint64_t deadline)
+        {
+            uint64_t due = std::max((deadline + tick - 1) / tick, wheel.now() / tick + 1);   ///never the current tick
+            armed[nextId] = Armed{wheel.arm(deadline, nextId), dueTicks.emplace(due, nextId)};
+            ++nextId;
+        };
+
+        for(int step = 0; step < 100'000; ++step)
+        {
+            unsigned op = rng() % 10;
+            if(op < 5)
+            {
+                uint64_t ahead = rng() % 3 == 0 ? rng() % 100'000 : rng() % 300;   ///some past the top wheel
+                uint64_t behind = rng() % 5 == 0 ? rng() % 20 : 0;                 ///some already due
+                arm(now + ahead - std::min(behind, now + ahead));
+            }
+            else if(op < 7 && !armed.empty())
+            {
+                auto victim = std::next(armed.begin(), static_cast<long>(rng() % std::min<size_t>(armed.size(), 50)));
+                assert(wheel.cancel(victim->second.handle));
+                assert(!wheel.cancel(victim->second.handle));
+                dueTicks.erase(victim->second.due);
+                armed.erase(victim);
+            }
+            else
+            {
+                now += rng() % (rng() % 50 == 0 ? 200'000 : 40);
+                wheel.advance(now, [&](int id)
+                {
+                    auto found = armed.find(id);
+                    assert(found != armed.end());
+                    assert(found->second.due->first == wheel.now() / tick);
+                    assert(!wheel.isArmed(found->second.handle));
+                    dueTicks.erase(found->second.due);
+                    armed.erase(found);
+                    if(id % 7 == 0)
+                        arm(wheel.now());                ///re-arm from inside the callback
+                });
+                assert(dueTicks.empty() || dueTicks.begin()->first > wheel.now() / tick);
+            }
+            assert(wheel.size() == armed.size());
+        }
+        wheel.advance(now + 10'000'000, [&](int id) { dueTicks.erase(armed.at(id).due); armed.erase(id); });
+        assert(armed.empty() && dueTicks.empty() && wheel.isEmpty());
+    }
+}
+
+int main()
+{
+    cancelSlotMateFromCallback();
+    rearmFromCallback();
+    overflowChurn();
+    randomAgainstMultimap(1, 3, 3, 1);
+    randomAgainstMultimap(1, 2, 4, 2);
+    randomAgainstMultimap(7, 2, 4, 3);                  ///ticks longer than one time unit
+    std::printf("TimingWheel: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/// Streaming top-K selector. Keeps the K best items seen so far in O(K) memory,
+/// where "best" follows Heap's convention: std::less keeps the K largest.
+/// The items live in a fixed-capacity binary heap with Heap's array layout whose
+/// root is the worst item kept, so a losing candidate costs one compare.
+template<typename T, typename Compare = std::less<T>>
+class TopK
+{
+    private:
+        static constexpr size_t CHUNK = 16;             /// candidates rejected together by push_batch
+
+        std::vector<T> array;                           /// root = worst of the kept items
+        size_t k;
+        Compare comp;
+
+        void siftUp(size_t index);
+        void siftDown(size_t index);
+        void replaceTop(const T& value);
+        size_t firstCandidate(const T* data, size_t index, size_t n) const;   /// skips whole chunks that cannot enter
+
+    public:
+        explicit TopK(size_t k, const Compare& compare = Compare{});
+
+        TopK(const TopK& src) = default;
+        TopK& operator=(const TopK& rhs) = default;
+        TopK(TopK&& src) noexcept = default;
+        TopK& operator=(TopK&& rhs) noexcept = default;
+        ~TopK() = default;
+
+        bool push(const T& value);                      ////////////////  TC O(1) reject, log K accept
+        void push_batch(std::span<const T> values);
+        void merge(const TopK& other);                  ////////////////  TC K log K
+
+        const T& threshold() const;                     /// worst kept item; candidates must beat it once full
+        std::vector<T> results() const;                 /// best first
+        size_t size() const;
+        size_t capacity() const;
+        bool isFull() const;
+        bool isEmpty() const;
+        void clear();
+};
+
+template<typename T, typename Compare>
+TopK<T, Compare>::TopK(size_t k, const Compare& compare) : k{k}, comp{compare}
+{
+    array.reserve(k);
+}
+
+template<typename T, typename Compare>
+void TopK<T, Compare>::siftUp(size_t index)
+{
+    T tmp = std::move(array[index]);
+    while(index != 0 && comp(tmp, array[(index-1)/2]))
+    {
+        array[index] = std::move(array[(index-1)/2]);
+        index = (index-1)/2;
+    }
+    array[index] = std::move(tmp);
+}
+
+template<typename T, typename Compare>
+void TopK<T, Compare>::siftDown(size_t index)
+{
+    const size_t n = array.size();
+    T tmp = std::move(array[index]);
+    while(2*index + 1 < n)
+    {
+        size_t worst = 2*index + 1;
+        if(worst + 1 < n && comp(array[worst + 1], array[worst]))
+            ++worst;
+        if(!comp(array[worst], tmp))
+            break;
+        array[index] = std::move(array[worst]);
+        index = worst;
+    }
+    array[index] = std::move(tmp);
+}
+
+template<typename T, typename Compare>
+void TopK<T, Compare>::replaceTop(const T& value)
+{
+    array[0] = value;
+    siftDown(0);
+}
+
+template<typename T, typename Compare>
+bool TopK<T, Compare>::push(const T& value)
+{
+    if(array.size() < k)
+    {
+        array.push_back(value);
+        siftUp(array.size() - 1);
+        return true;
+    }
+    if(k == 0 || !comp(array[0], value))
+        return false;
+    replaceTop(value);
+    return true;
+}
+
+template<typename T, typename Compare>
+size_t TopK<T, Compare>::firstCandidate(const T* data, size_t index, size_t n) const
+{
+    const T threshold = array[0];
+
+#if defined(__SSE2__)
+    constexpr bool keepLargest = std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>;
+    constexpr bool keepSmallest = std::is_same_v<Compare, std::greater<T>> || std::is_same_v<Compare, std::greater<>>;
+    if constexpr((std::is_same_v<T, int32_t> || std::is_same_v<T, float>) && (keepLargest || keepSmallest))
+    {
+        for(; index + CHUNK <= n; index += CHUNK)
+        {
+            int passed = 0;
+            if constexpr(std::is_same_v<T, int32_t>)
+            {
+                const __m128i t = _mm_set1_epi32(threshold);
+                for(size_t j = 0; j < CHUNK; j += 4)
+                {
+                    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index + j));
+                    __m128i hit = keepLargest ? _mm_cmpgt_epi32(x, t) : _mm_cmplt_epi32(x, t);
+                    passed |= _mm_movemask_epi8(hit);
+                }
+            }
+            else
+            {
+                const __m128 t = _mm_set1_ps(threshold);
+                for(size_t j = 0; j < CHUNK; j += 4)
+                {
+                    __m128 x = _mm_loadu_ps(data + index + j);
+                    __m128 hit = keepLargest ? _mm_cmpgt_ps(x, t) : _mm_cmplt_ps(x, t);
+                    passed |= _mm_movemask_ps(hit);
+                }
+            }
+            if(passed)
+                return index;
+        }
+        return index;
+    }
+#endif
+
+    /// branch-free inner loop, which compilers turn into packed compares for arithmetic T
+    for(; index + CHUNK <= n; index += CHUNK)
+    {
+        bool passed = false;
+        for(size_t j = 0; j < CHUNK; ++j)
+            passed |= comp(threshold, data[index + j]);
+        if(passed)
+            return index;
+    }
+    return index;
+}
+
+template<typename T, typename Compare>
+void TopK<T, Compare>::push_batch(std::span<const T> values)
+{
+    const T* data = values.data();
+    const size_t n = values.size();
+    size_t i = 0;
+    while(i < n && array.size() < k)
+        push(data[i++]);
+    if(k == 0)
+        return;
+
+    while(i < n)
+    {
+        i = firstCandidate(data, i, n);
+        size_t end = std::min(i + CHUNK, n);
+        for(; i < end; ++i)
+        {
+            if(comp(array[0], data[i]))
+                replaceTop(data[i]);
+        }
+    }
+}
+
+template<typename T, typename Compare>
+void TopK<T, Compare>::merge(const TopK& other)
+{
+    for(const T& item : other.array)
+        push(item);
+}
+
+template<typename T, typename Compare>
+const T& TopK<T, Compare>::threshold() const
+{
+    if(array.empty())
+        throw std::range_error("TopK is empty");
+    return array[0];
+}
+
+template<typename T, typename Compare>
+std::vector<T> TopK<T, Compare>::results() const
+{
+    std::vector<T> sorted{array};
+    std::sort(sorted.begin(), sorted.end(), [this](const T& a, const T& b) { return comp(b, a); });
+    return sorted;
+}
+
+template<typename T, typename Compare>
+size_t TopK<T, Compare>::size() const
+{
+    return array.size();
+}
+
+template<typename T, typename Compare>
+size_t TopK<T, Compare>::capacity() const
+{
+    return k;
+}
+
+template<typename T, typename Compare>
+bool TopK<T, Compare>::isFull() const
+{
+    return array.size() == k;
+}
+
+template<typename T, typename Compare>
+bool TopK<T, Compare>::isEmpty() const
+{
+    return array.empty();
+}
+
+template<typename T, typename Compare>
+void TopK<T, Compare>::clear()
+{
+    array.clear();
+}
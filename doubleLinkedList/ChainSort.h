@@ -0,0 +1,101 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+
+namespace DLL{
+    /// Bottom-up natural merge sort on a null-terminated chain, shared by the lists
+    /// in this directory. Only forward links are touched; the caller rebuilds the
+    /// backward ones in a single pass afterwards.
+    ///     next(node)  - reference to node's forward link
+    ///     less(a, b)  - compares two nodes
+    /// Stable, O(n log r) for r ascending runs, O(1) extra space.
+    namespace chain{
+        template<typename Node, typename Next, typename Less>
+        Node* cutRun(Node* start, Node*& last, Next& next, Less& less);     /// detaches the ascending run at start
+        template<typename Node, typename Next, typename Less>
+        Node* merge(Node* a, Node* lastA, Node* b, Node* lastB, Node*& last, Next& next, Less& less);
+        template<typename Node, typename Next, typename Less>
+        Node* sort(Node* head, Node*& last, Next& next, Less& less);
+    }
+
+    template<typename Node, typename Next, typename Less>
+    Node* chain::cutRun(Node* start, Node*& last, Next& next, Less& less)
+    {
+        last = start;
+        while(next(last) != nullptr && !less(next(last), last))
+        {
+            last = next(last);
+        }
+        Node* rest = next(last);
+        next(last) = nullptr;
+        return rest;
+    }
+
+    template<typename Node, typename Next, typename Less>
+    Node* chain::merge(Node* a, Node* lastA, Node* b, Node* lastB, Node*& last, Next& next, Less& less)   ///iterative, a wins ties
+    {
+        Node* merged = nullptr;
+        Node** link = &merged;
+        while(a != nullptr && b != nullptr)
+        {
+            if(less(b, a))
+            {
+                *link = b;
+                b = next(b);
+            }
+            else
+            {
+                *link = a;
+                a = next(a);
+            }
+            link = &next(*link);
+        }
+        *link = a != nullptr ? a : b;
+        last = a != nullptr ? lastA : lastB;
+        return merged;
+    }
+
+    template<typename Node, typename Next, typename Less>
+    Node* chain::sort(Node* head, Node*& last, Next& next, Less& less)
+    {
+        constexpr size_t LEVELS = 64;                   ///level k holds 2^k runs, so 64 fixed slots always suffice
+        Node* pending[LEVELS] = {};
+        Node* pendingLast[LEVELS] = {};
+        size_t used = 0;
+
+        while(head != nullptr)                          ///binary counter: equal levels merge while still in cache
+        {
+            Node* carryLast = nullptr;
+            Node* carry = head;
+            head = cutRun(carry, carryLast, next, less);
+            size_t level = 0;
+            for(; level < LEVELS - 1 && pending[level] != nullptr; ++level)
+            {
+                carry = merge(pending[level], pendingLast[level], carry, carryLast, carryLast, next, less);
+                pending[level] = nullptr;
+            }
+            if(pending[level] != nullptr)               ///only reachable past 2^63 runs, kept for safety
+                carry = merge(pending[level], pendingLast[level], carry, carryLast, carryLast, next, less);
+            pending[level] = carry;
+            pendingLast[level] = carryLast;
+            used = std::max(used, level + 1);
+        }
+
+        Node* result = nullptr;
+        last = nullptr;
+        for(size_t level = 0; level < used; ++level)    ///higher levels hold earlier elements
+        {
+            if(pending[level] == nullptr)
+                continue;
+            if(result == nullptr)
+            {
+                result = pending[level];
+                last = pendingLast[level];
+            }
+            else
+                result = merge(pending[level], pendingLast[level], result, last, last, next, less);
+        }
+        return result;
+    }
+}
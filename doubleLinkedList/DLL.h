@@ -1,7 +1,16 @@
 #pragma once
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
+#include "ChainSort.h"
+#include "NodePool.h"
 
 
 namespace DLL{
@@ -19,18 +28,66 @@ namespace DLL{
                     Node(U&& value = U{}) : m_data{std::forward<U>(value)}{};   ///perfect Forwarding
             };
 
+            template<bool Const>
+            class Iterator
+            {
+                    friend class Dll;
+                    template<bool> friend class Iterator;
+                    using NodePtr = std::conditional_t<Const, const Node*, Node*>;
+
+                    NodePtr node{nullptr};
+                    const Dll* list{nullptr};                        ///only read to step back from end()
+
+                    Iterator(NodePtr node, const Dll* list) : node{node}, list{list} {}
+
+                public:
+                    using iterator_category = std::bidirectional_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = std::conditional_t<Const, const T*, T*>;
+                    using reference = std::conditional_t<Const, const T&, T&>;
+
+                    Iterator() = default;
+                    operator Iterator<true>() const { return {node, list}; }
+
+                    reference operator*() const { return node->m_data; }
+                    pointer operator->() const { return &node->m_data; }
+                    Iterator& operator++() { node = node->m_next; return *this; }
+                    Iterator operator++(int) { Iterator old{*this}; ++*this; return old; }
+                    Iterator& operator--() { node = node == nullptr ? list->tail : node->m_prev; return *this; }
+                    Iterator operator--(int) { Iterator old{*this}; --*this; return old; }
+                    bool operator==(const Iterator& rhs) const { return node == rhs.node; }
+                    bool operator!=(const Iterator& rhs) const { return !(*this == rhs); }
+            };
+
+        public:
+            using Pool = NodePool<Node>;                     ///share one between lists with Dll(std::make_shared<Pool>())
+            using iterator = Iterator<false>;
+            using const_iterator = Iterator<true>;
+
+        private:
             size_t m_itemCount{0};
             Node* head{nullptr};
             Node* tail{nullptr};
+            std::shared_ptr<Pool> pool;                     ///created on the first insert unless one is passed in
 
+            Pool& nodePool();
+            template<typename U>
+            Node* createNode(U&& value);
+            void destroyNode(Node* node);
+            void adoptNodes(Dll<T>& src);                   ///moves src's elements into our pool when the pools differ
             void validRange(size_t index) const;
-            Node* mergeTwoLists(Node* head1, Node* head2);   ///for mergeSort
-            Node* mergeSort(Node* head);
-            Node* getMiddleNode(Node* head);                 ///for mergeSort
-            void setTail();
+            static Node*& nextOf(Node* node) { return node->m_next; }          ///link and order for chain::sort
+            static bool nodeLess(const Node* a, const Node* b) { return a->m_data < b->m_data; }
+            void relinkBackward();                           ///rebuilds m_prev and tail in one pass
+            bool sharesPoolWith(Dll<T>& other);              ///takes other's pool if we have none yet
+            static Node* nodeOf(const_iterator pos) { return const_cast<Node*>(pos.node); }
+            void unlink(Node* first, Node* last);            ///detaches [first, last] without touching m_itemCount
+            void link(Node* pos, Node* first, Node* last);   ///attaches [first, last] before pos (nullptr = end)
 
         public:
             Dll();
+            explicit Dll(std::shared_ptr<Pool> pool);
             Dll(std::initializer_list<T> list);
             Dll(const Dll<T>& src);
             Dll<T>& operator=(const Dll<T>& rhs);
@@ -49,9 +106,15 @@ namespace DLL{
             void remove(size_t index);
             void reverse();                 /// iterative
             Node* reverse(Node* head);      /// recursive
-            void merge(Dll<T>&& rhs);
+            void merge(Dll<T>&& rhs);                        /// both sorted; stable, rhs ends empty, TC n + m
+
+            iterator splice(const_iterator pos, Dll<T>& other);     /// all of other before pos, TC 1
+            iterator splice(const_iterator pos, Dll<T>& other, const_iterator first, const_iterator last);  /// [first, last) before pos, TC k
+            Dll<T> split_at(const_iterator pos);             /// moves [pos, end) out, TC k
+            void append(Dll<T>&& rhs);                       ////////////////  TC 1
 
-            void sort();     ////delegating to private mergesort
+            void sort();                                     ////////////////  TC n log runs, O(1) space
+            void parallelSort(unsigned threads = 0);         /// 0 = hardware concurrency; comparisons must not throw
             void clear();
 
             static bool hasCycle(Node* head);
@@ -62,6 +125,12 @@ namespace DLL{
             void printFromTail() const;
             size_t size() const;
             Node* getHead() const;
+            std::shared_ptr<Pool> getPool() const;
+
+            iterator begin() { return {head, this}; }
+            iterator end() { return {nullptr, this}; }
+            const_iterator begin() const { return {head, this}; }
+            const_iterator end() const { return {nullptr, this}; }
 
             ~Dll(){clear();}                   
 
@@ -76,14 +145,50 @@ namespace DLL{
         }
     }
 
+    template<typename T>
+    typename DLL::Dll<T>::Pool& DLL::Dll<T>::nodePool()
+    {
+        if(!pool)
+            pool = std::make_shared<Pool>();
+        return *pool;
+    }
+
+    template<typename T>
+    template<typename U>
+    typename DLL::Dll<T>::Node* DLL::Dll<T>::createNode(U&& value)
+    {
+        Pool& nodes = nodePool();
+        void* memory = nodes.allocate();
+        try
+        {
+            return new (memory) Node{std::forward<U>(value)};
+        }
+        catch(...)
+        {
+            nodes.deallocate(memory);
+            throw;
+        }
+    }
+
+    template<typename T>
+    void DLL::Dll<T>::destroyNode(Node* node)
+    {
+        node->~Node();
+        pool->deallocate(node);
+    }
+
     template<typename T>                                                  /// default ctor
     DLL::Dll<T>::Dll() : m_itemCount{0},
                          head{nullptr},
                          tail{nullptr}
     {}
 
+    template<typename T>                                                  /// shared pool ctor
+    DLL::Dll<T>::Dll(std::shared_ptr<Pool> pool) : pool{std::move(pool)}
+    {}
+
     template<typename T>
-    DLL::Dll<T>::Dll(const Dll<T>& src) : m_itemCount{src.m_itemCount}    /// copy ctor
+    DLL::Dll<T>::Dll(const Dll<T>& src)                                   /// copy ctor
     {
         Node* current = src.head;
         try
@@ -107,19 +212,10 @@ namespace DLL{
     {
         try
         {
-            auto iter = list.begin();
-            head = new Node{*iter};
-            Node* current = head;
-            m_itemCount = list.size();
-            ++iter;
-            while(iter != list.end())
+            for(const T& item : list)
             {
-                current->m_next = new Node{*iter};
-                current->m_next->m_prev = current;
-                current = current->m_next;
-                ++iter;
+                push_back(item);
             }
-            tail = current;
         }
         catch (const std::bad_alloc& e)
         {
@@ -134,30 +230,32 @@ namespace DLL{
         if(this == &rhs)
             return *this;
 
-        Dll<T> tmp{rhs};
-        m_itemCount = tmp.m_itemCount;
-        clear();
-        head = tmp.head;
-        tail = tmp.tail;
-        tmp.head = nullptr;
+        Dll<T> tmp{rhs};                                ///tmp leaves with our old nodes and pool
+        std::swap(m_itemCount, tmp.m_itemCount);
+        std::swap(head, tmp.head);
+        std::swap(tail, tmp.tail);
+        std::swap(pool, tmp.pool);
         return *this;
     }
 
     template<typename T>
     DLL::Dll<T>::Dll(DLL::Dll<T>&& src) noexcept                            ///move ctor
-                    : m_itemCount{src.m_itemCount},
+                    : m_itemCount{std::exchange(src.m_itemCount,0)},
                     head{std::exchange(src.head,nullptr)},
-                    tail{std::exchange(src.tail,nullptr)}                           
+                    tail{std::exchange(src.tail,nullptr)},
+                    pool{std::move(src.pool)}
     {}
 
     template<typename T>
     DLL::Dll<T>& DLL::Dll<T>::operator=(DLL::Dll<T>&& rhs) noexcept        ///move assignment 
     {
+        if(this == &rhs)
+            return *this;
         clear();
-        m_itemCount = rhs.m_itemCount;
-        head = rhs.head;
-        tail = rhs.tail;
-        rhs.head = nullptr;
+        m_itemCount = std::exchange(rhs.m_itemCount,0);
+        head = std::exchange(rhs.head,nullptr);
+        tail = std::exchange(rhs.tail,nullptr);
+        pool = std::move(rhs.pool);                     ///the nodes stay in the pool they came from
         return *this;
     }
 
@@ -165,7 +263,6 @@ namespace DLL{
     template<typename U>
     void DLL::Dll<T>::insert(size_t index,U&& value)
     {
-        Node* newNode = new Node{std::forward<U>(value)};
         if(index == 0)
         {
             push_front(std::forward<U>(value));
@@ -173,6 +270,7 @@ namespace DLL{
         else
         {
             validRange(index);
+            Node* newNode = createNode(std::forward<U>(value));
             Node* current = head;
             size_t count = 0;
             while(count != index-1)
@@ -192,20 +290,15 @@ namespace DLL{
     template<typename U>
     void DLL::Dll<T>::push_back(U&& value)
     {
-        Node* newNode = new Node{std::forward<U>(value)};
+        Node* newNode = createNode(std::forward<U>(value));
         if(isempty())
         {
             head = newNode;
         }
         else
         {
-            Node* current = head;
-            while(current->m_next != nullptr)
-            {
-                current = current->m_next;
-            }
-            current->m_next = newNode;
-            newNode->m_prev = current;
+            tail->m_next = newNode;                     ///O(1) through tail
+            newNode->m_prev = tail;
         }
         tail = newNode; 
         ++m_itemCount;
@@ -219,15 +312,14 @@ namespace DLL{
             if(head == tail)
             {
                 tail = nullptr;
-                delete head;
+                destroyNode(head);
                 head = nullptr;
             }
             else
             {
                 tail = tail->m_prev;
-                delete tail->m_next;
+                destroyNode(tail->m_next);
                 tail->m_next = nullptr;
-                
             }
             --m_itemCount;
         }
@@ -237,7 +329,7 @@ namespace DLL{
     template<typename U>
     void DLL::Dll<T>::push_front(U&& value)
     {
-        Node* newnode = new Node{std::forward<U>(value)};
+        Node* newnode = createNode(std::forward<U>(value));
         if(!isempty())
         {
             head->m_prev = newnode;
@@ -257,14 +349,13 @@ namespace DLL{
     {
         if(!isempty())
         {
-            if(head == tail)
-            {
-                head = tail = head->m_next;
-                return;
-            }
             Node* current = head;
             head = current->m_next;
-            delete current;
+            if(head != nullptr)
+                head->m_prev = nullptr;
+            else
+                tail = nullptr;
+            destroyNode(current);
             --m_itemCount;
         }
     }
@@ -294,7 +385,7 @@ namespace DLL{
             }
             current->m_prev->m_next = current->m_next;
             current->m_next->m_prev = current->m_prev;
-            delete current;
+            destroyNode(current);
             --m_itemCount;        
         }
     }
@@ -338,24 +429,6 @@ namespace DLL{
         return head;
     }
 
-    template<typename T>
-    typename DLL::Dll<T>::Node* Dll<T>::getMiddleNode(DLL::Dll<T>::Node* head)     ///get middle node in 1/2n time complexity
-    {
-        if(!isempty())
-        {
-            Node* fast = head;
-            Node* slow = head;
-            while(fast->m_next != nullptr && fast->m_next->m_next != nullptr)
-            {
-                slow = slow->m_next;
-                fast = fast->m_next->m_next;
-            }
-            return slow;
-        }
-        return head;
-
-    }
-
     template<typename T>
     bool DLL::Dll<T>::hasCycle(DLL::Dll<T>::Node* head)
     {
@@ -407,106 +480,227 @@ namespace DLL{
     template<typename T>
     void DLL::Dll<T>::merge(DLL::Dll<T>&& rhs)  
     {
-        if(rhs.head == nullptr)
+        if(this == &rhs || rhs.head == nullptr)
             return;
+        adoptNodes(rhs);
 
-        Node* lhs_head = this->head;
-        if(this->head->m_data <= rhs.head->m_data)
-        {
-            lhs_head = lhs_head->m_next;
-        }
+        Node* last = nullptr;
+        head = chain::merge(head, tail, rhs.head, rhs.tail, last, nextOf, nodeLess);    ///either side may be empty
+        relinkBackward();
+        m_itemCount += std::exchange(rhs.m_itemCount, 0);
+        rhs.head = nullptr;
+        rhs.tail = nullptr;
+    }
+
+    template<typename T>
+    bool DLL::Dll<T>::sharesPoolWith(Dll<T>& other)
+    {
+        if(!pool)                                       ///nothing of ours yet - just share theirs
+            pool = other.pool;
+        return pool == other.pool;
+    }
+
+    template<typename T>
+    void DLL::Dll<T>::unlink(Node* first, Node* last)
+    {
+        if(first->m_prev != nullptr)
+            first->m_prev->m_next = last->m_next;
+        else
+            head = last->m_next;
+        if(last->m_next != nullptr)
+            last->m_next->m_prev = first->m_prev;
+        else
+            tail = first->m_prev;
+        first->m_prev = nullptr;
+        last->m_next = nullptr;
+    }
+
+    template<typename T>
+    void DLL::Dll<T>::link(Node* pos, Node* first, Node* last)
+    {
+        Node* before = pos != nullptr ? pos->m_prev : tail;
+        first->m_prev = before;
+        last->m_next = pos;
+        if(before != nullptr)
+            before->m_next = first;
+        else
+            head = first;
+        if(pos != nullptr)
+            pos->m_prev = last;
         else
+            tail = last;
+    }
+
+    template<typename T>
+    typename DLL::Dll<T>::iterator DLL::Dll<T>::splice(const_iterator pos, Dll<T>& other)
+    {
+        if(this == &other || other.isempty())
+            return {nodeOf(pos), this};
+        if(!sharesPoolWith(other))                      ///nodes must live in our pool - relocate them
+            return splice(pos, other, other.begin(), other.end());
+
+        Node* first = std::exchange(other.head, nullptr);
+        Node* last = std::exchange(other.tail, nullptr);
+        link(nodeOf(pos), first, last);
+        m_itemCount += std::exchange(other.m_itemCount, 0);
+        return {first, this};
+    }
+
+    template<typename T>
+    typename DLL::Dll<T>::iterator DLL::Dll<T>::splice(const_iterator pos, Dll<T>& other, const_iterator first, const_iterator last)
+    {
+        if(first == last)
+            return {nodeOf(pos), this};
+        Node* firstNode = nodeOf(first);
+        Node* lastNode = last.node != nullptr ? nodeOf(last)->m_prev : other.tail;   ///inclusive from here on
+        if(this == &other)                              ///pos must not lie inside (first, last)
         {
-            this->head = rhs.head;
-            rhs.head = rhs.head->m_next;
+            if(pos == first)
+                return {firstNode, this};
+            unlink(firstNode, lastNode);
+            link(nodeOf(pos), firstNode, lastNode);
+            return {firstNode, this};
         }
 
-        Node* current = this->head;
-        while(lhs_head != nullptr && rhs.head != nullptr)
+        size_t count = 1;
+        for(Node* current = firstNode; current != lastNode; current = current->m_next)
+            ++count;
+
+        if(!sharesPoolWith(other))
         {
-            if(rhs.head->m_data <= lhs_head->m_data)
+            Dll<T> moved(pool);                         ///if a move throws, other keeps every node
+            for(Node* current = firstNode; ; current = current->m_next)
             {
-                current->m_next =  rhs.head;
-                rhs.head->m_prev = current;
-                rhs.head = rhs.head->m_next;
+                moved.push_back(std::move(current->m_data));
+                if(current == lastNode)
+                    break;
             }
-            else
+            other.unlink(firstNode, lastNode);
+            other.m_itemCount -= count;
+            while(firstNode != nullptr)
             {
-                current->m_next = lhs_head;
-                lhs_head->m_prev = current;
-                lhs_head = lhs_head->m_next;
+                Node* next = firstNode->m_next;
+                other.destroyNode(firstNode);
+                firstNode = next;
             }
-            current = current->m_next;
+            return splice(pos, moved);
         }
 
-        if(!lhs_head)
-        {
-            current->m_next = rhs.head;
-            rhs.head->m_prev = current;
-            this->tail = rhs.head;
-        }
-        else
-        {
-            current->m_next = lhs_head;
-            lhs_head->m_prev = current;
-        }
-        rhs.head = nullptr;
-        rhs.tail = nullptr;
+        other.unlink(firstNode, lastNode);
+        other.m_itemCount -= count;
+        link(nodeOf(pos), firstNode, lastNode);
+        m_itemCount += count;
+        return {firstNode, this};
     }
 
     template<typename T>
-    typename DLL::Dll<T>::Node* Dll<T>::mergeTwoLists(DLL::Dll<T>::Node* h1, DLL::Dll<T>::Node* h2)   ///recursive
+    DLL::Dll<T> DLL::Dll<T>::split_at(const_iterator pos)
     {
-        if(!h1){ return h2; }
-        if(!h2){ return h1; }
-        if(h1->m_data <= h2->m_data)
+        Dll<T> rest(pool);                              ///same pool, so the nodes just change owner
+        Node* first = nodeOf(pos);
+        if(first == nullptr)
+            return rest;
+
+        size_t count = m_itemCount;
+        if(first != head)
         {
-            h1->m_next = mergeTwoLists(h1->m_next,h2);
-            h1->m_next->m_prev = h1;
-            return h1;
+            count = 0;
+            for(Node* current = first; current != nullptr; current = current->m_next)
+                ++count;
         }
+        rest.head = first;
+        rest.tail = tail;
+        rest.m_itemCount = count;
+        tail = first->m_prev;
+        if(tail != nullptr)
+            tail->m_next = nullptr;
         else
-        {
-            h2->m_next = mergeTwoLists(h1,h2->m_next);
-            h2->m_next->m_prev = h2;
-            return h2;
-        }
+            head = nullptr;
+        first->m_prev = nullptr;
+        m_itemCount -= count;
+        return rest;
+    }
 
+    template<typename T>
+    void DLL::Dll<T>::append(Dll<T>&& rhs)
+    {
+        splice(end(), rhs);
     }
 
     template<typename T>
-    typename DLL::Dll<T>::Node* DLL::Dll<T>::mergeSort(DLL::Dll<T>::Node* head)
+    void DLL::Dll<T>::relinkBackward()
     {
-        if(!head || !head->m_next)
+        Node* prev = nullptr;
+        for(Node* current = head; current != nullptr; current = current->m_next)
         {
-            return head;
+            current->m_prev = prev;
+            prev = current;
         }
-        DLL::Dll<T>::Node* mid = getMiddleNode(head);
-        DLL::Dll<T>::Node* tmp = mid;
-        mid = mid -> m_next;
-        tmp->m_next->m_prev = nullptr;
-        tmp->m_next = nullptr;
-        head = mergeSort(head);
-        mid = mergeSort(mid);
-        return  mergeTwoLists(head,mid);
+        tail = prev;
     }
 
     template<typename T>
     void DLL::Dll<T>::sort()
     {
-        this->head = mergeSort(this->head);
-        setTail();
+        Node* last = nullptr;
+        head = chain::sort(head, last, nextOf, nodeLess);
+        relinkBackward();
     }
 
     template<typename T>
-    void DLL::Dll<T>::setTail()
+    void DLL::Dll<T>::parallelSort(unsigned threads)
     {
+        constexpr size_t MIN_CHUNK = 1 << 14;           ///smaller pieces are not worth a thread
+        if(threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<size_t>(threads, m_itemCount / MIN_CHUNK));
+        if(threads < 2)
+        {
+            sort();
+            return;
+        }
+
+        std::vector<std::pair<Node*, Node*>> chunks(threads);   ///first and last node of each piece
         Node* current = head;
-        while(current->m_next != nullptr)
+        for(unsigned i = 0; i < threads; ++i)           ///cut into equal, null-terminated pieces
         {
-            current = current->m_next;
+            chunks[i].first = current;
+            size_t length = m_itemCount / threads + (i < m_itemCount % threads);
+            for(size_t k = 1; k < length; ++k)
+                current = current->m_next;
+            Node* next = current->m_next;
+            current->m_next = nullptr;
+            current = next;
         }
-        this->tail = current;
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for(unsigned i = 0; i < threads; ++i)
+            workers.emplace_back([&chunks, i] { chunks[i].first = chain::sort(chunks[i].first, chunks[i].second, nextOf, nodeLess); });
+        for(std::thread& worker : workers)
+            worker.join();
+
+        while(chunks.size() > 1)                        ///merge tree, one round of pairs at a time
+        {
+            std::vector<std::pair<Node*, Node*>> merged((chunks.size() + 1) / 2);
+            workers.clear();
+            for(size_t i = 0; i + 1 < chunks.size(); i += 2)
+            {
+                workers.emplace_back([&chunks, &merged, i]
+                {
+                    auto [a, lastA] = chunks[i];
+                    auto [b, lastB] = chunks[i + 1];
+                    merged[i / 2].first = chain::merge(a, lastA, b, lastB, merged[i / 2].second, nextOf, nodeLess);
+                });
+            }
+            if(chunks.size() % 2 != 0)
+                merged.back() = chunks.back();
+            for(std::thread& worker : workers)
+                worker.join();
+            chunks = std::move(merged);
+        }
+        head = chunks[0].first;
+        relinkBackward();
     }
 
     template<typename T>
@@ -540,16 +734,52 @@ namespace DLL{
         std::cout << std::endl;
     }
 
+    template<typename T>
+    void DLL::Dll<T>::adoptNodes(Dll<T>& src)
+    {
+        if(sharesPoolWith(src))
+            return;
+        for(Node* current = src.head; current != nullptr; current = current->m_next)
+        {
+            Node* copy = createNode(std::move(current->m_data));
+            copy->m_prev = current->m_prev;
+            copy->m_next = current->m_next;
+            if(copy->m_prev != nullptr)
+                copy->m_prev->m_next = copy;
+            else
+                src.head = copy;
+            if(copy->m_next != nullptr)
+                copy->m_next->m_prev = copy;
+            else
+                src.tail = copy;
+            src.destroyNode(current);
+            current = copy;
+        }
+    }
+
     template<typename T>
     void DLL::Dll<T>::clear()
     {
-        Node* current = head;
-        while(current != nullptr)
+        if(pool && pool.use_count() == 1)               ///sole owner: give whole slabs back at once
         {
-            current = current->m_next;
-            delete head;
-            head = current;
+            if constexpr(!std::is_trivially_destructible_v<T>)
+            {
+                for(Node* current = head; current != nullptr; current = current->m_next)
+                    current->~Node();
+            }
+            pool->reset();
+        }
+        else
+        {
+            Node* current = head;
+            while(current != nullptr)
+            {
+                current = current->m_next;
+                destroyNode(head);
+                head = current;
+            }
         }
+        head = nullptr;
         tail = nullptr;
         m_itemCount = 0;
     }
@@ -565,4 +795,10 @@ namespace DLL{
     {
         return this->head;
     }
+
+    template<typename T>
+    std::shared_ptr<typename DLL::Dll<T>::Pool> DLL::Dll<T>::getPool() const
+    {
+        return pool;
+    }
 }
\ No newline at end of file
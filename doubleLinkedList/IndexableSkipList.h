@@ -0,0 +1,594 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace DLL{
+    /// Sequence container with Dll's interface where positional access, insert,
+    /// remove and split_at all take O(log n) expected time.
+    /// A skip list whose links also store their width - how many positions they
+    /// jump - so a search by index adds up widths instead of comparing keys.
+    /// Positions count from the head (0); element i sits at position i + 1 and
+    /// a null link reaches position size + 1. Level 0 also keeps prev pointers.
+    template<typename T>
+    class IndexableSkipList
+    {
+        private:
+            static constexpr unsigned MAX_LEVEL = 32;  /// p = 1/4, so enough for 4^32 elements
+
+            struct Node;
+            struct Link
+            {
+                Node* next;
+                size_t width;
+            };
+            struct Node
+            {
+                Node* prev{nullptr};                    /// level 0, nullptr before the first
+                uint32_t level;
+                alignas(T) unsigned char storage[sizeof(T)];
+
+                T& value() { return *std::launder(reinterpret_cast<T*>(storage)); }
+                Link* links() { return reinterpret_cast<Link*>(reinterpret_cast<unsigned char*>(this) + LINKS_OFFSET); }
+            };
+            static constexpr size_t LINKS_OFFSET = (sizeof(Node) + alignof(Link) - 1) / alignof(Link) * alignof(Link);
+
+            Link headLinks[MAX_LEVEL];                  /// valid below m_level; above it they reach size + 1
+            unsigned m_level{1};
+            size_t m_itemCount{0};
+            Node* tail{nullptr};
+            uint64_t rng{0x9E3779B97F4A7C15ull};
+
+            Link* linksOf(Node* node) { return node ? node->links() : headLinks; }
+            unsigned randomLevel();
+            template<typename U>
+            Node* createNode(U&& value, unsigned level);
+            static void destroyNode(Node* node);
+            void validRange(size_t index) const;
+            void raiseLevel(unsigned level);            /// opens head levels up to level
+            void lowerLevel();                          /// drops empty top levels
+            void findPath(size_t position, Node** update, size_t* updatePos);   /// last node before position, per level
+            Node* nodeAt(size_t index);
+            template<typename U>
+            void insertAt(size_t index, U&& value);
+            void removeAt(size_t index);
+            void rebuild(Node* first);                  /// relinks every level from the level-0 chain, O(n)
+            void takeFrom(IndexableSkipList& src);
+
+        public:
+            IndexableSkipList();
+            IndexableSkipList(std::initializer_list<T> list);
+            IndexableSkipList(const IndexableSkipList& src);
+            IndexableSkipList& operator=(const IndexableSkipList& rhs);
+            IndexableSkipList(IndexableSkipList&& src) noexcept;
+            IndexableSkipList& operator=(IndexableSkipList&& rhs) noexcept;
+            ~IndexableSkipList(){clear();}
+
+            template<typename U>
+            void push_back(U&& value);                  ////////////////  TC log n
+            void pop_back();
+            template<typename U>
+            void push_front(U&& value);                 ////////////////  TC log n
+            void pop_front();
+            template<typename U>
+            void insert(size_t index, U&& value);       ////////////////  TC log n
+            void remove(size_t index);                  ////////////////  TC log n
+            T& operator[](size_t index);                ////////////////  TC log n
+            T& at(size_t index);                        /// checked
+            IndexableSkipList split_at(size_t index);   /// moves [index, size) out, TC log n
+            void append(IndexableSkipList&& rhs);       ////////////////  TC log n
+            void reverse();                             ////////////////  TC n
+            void merge(IndexableSkipList&& rhs);        /// both sorted; stable, rhs ends empty, TC n + m
+            void sort();                                /// stable, TC n log n
+            void clear();
+
+            bool isempty() const;
+            void print();
+            void printFromTail();
+            size_t size() const;
+    };
+
+    template<typename T>
+    IndexableSkipList<T>::IndexableSkipList()
+    {
+        headLinks[0] = Link{nullptr, 1};
+    }
+
+    template<typename T>
+    unsigned IndexableSkipList<T>::randomLevel()
+    {
+        rng ^= rng << 13;                               ///xorshift64
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        unsigned level = 1 + std::countr_zero(rng | (uint64_t{1} << 62)) / 2;
+        return std::min(level, MAX_LEVEL);
+    }
+
+    template<typename T>
+    template<typename U>
+    typename IndexableSkipList<T>::Node* IndexableSkipList<T>::createNode(U&& value, unsigned level)
+    {
+        void* memory = ::operator new(LINKS_OFFSET + level * sizeof(Link), std::align_val_t{alignof(Node)});
+        Node* node = new (memory) Node;
+        node->level = level;
+        try
+        {
+            new (node->storage) T(std::forward<U>(value));
+        }
+        catch(...)
+        {
+            ::operator delete(memory, std::align_val_t{alignof(Node)});
+            throw;
+        }
+        return node;
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::destroyNode(Node* node)
+    {
+        node->value().~T();
+        node->~Node();
+        ::operator delete(node, std::align_val_t{alignof(Node)});
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::validRange(size_t index) const
+    {
+        if(index >= m_itemCount)
+        {
+            throw std::range_error("index is out of bounds");
+        }
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::raiseLevel(unsigned level)
+    {
+        for(; m_level < level; ++m_level)
+            headLinks[m_level] = Link{nullptr, m_itemCount + 1};
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::lowerLevel()
+    {
+        while(m_level > 1 && headLinks[m_level - 1].next == nullptr)
+            --m_level;
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::findPath(size_t position, Node** update, size_t* updatePos)
+    {
+        Node* current = nullptr;
+        size_t pos = 0;
+        for(unsigned level = m_level; level-- > 0;)
+        {
+            Link* links = linksOf(current);
+            while(links[level].next != nullptr && pos + links[level].width < position)
+            {
+                pos += links[level].width;
+                current = links[level].next;
+                links = current->links();
+            }
+            update[level] = current;
+            updatePos[level] = pos;
+        }
+    }
+
+    template<typename T>
+    typename IndexableSkipList<T>::Node* IndexableSkipList<T>::nodeAt(size_t index)
+    {
+        const size_t position = index + 1;
+        Node* current = nullptr;
+        size_t pos = 0;
+        for(unsigned level = m_level; level-- > 0;)
+        {
+            Link* links = linksOf(current);
+            while(links[level].next != nullptr && pos + links[level].width <= position)
+            {
+                pos += links[level].width;
+                current = links[level].next;
+                links = current->links();
+            }
+            if(pos == position)
+                return current;
+        }
+        return current;
+    }
+
+    template<typename T>
+    template<typename U>
+    void IndexableSkipList<T>::insertAt(size_t index, U&& value)
+    {
+        const unsigned level = randomLevel();
+        Node* node = createNode(std::forward<U>(value), level);
+        raiseLevel(level);
+
+        Node* update[MAX_LEVEL];
+        size_t updatePos[MAX_LEVEL];
+        findPath(index + 1, update, updatePos);
+
+        Link* links = node->links();
+        for(unsigned l = 0; l < m_level; ++l)
+        {
+            Link& before = linksOf(update[l])[l];
+            if(l < level)
+            {
+                links[l] = Link{before.next, updatePos[l] + before.width - index};
+                before = Link{node, index + 1 - updatePos[l]};
+            }
+            else
+            {
+                ++before.width;                         ///jumps over the new node
+            }
+        }
+
+        node->prev = update[0];
+        if(links[0].next != nullptr)
+            links[0].next->prev = node;
+        else
+            tail = node;
+        ++m_itemCount;
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::removeAt(size_t index)
+    {
+        Node* update[MAX_LEVEL];
+        size_t updatePos[MAX_LEVEL];
+        findPath(index + 1, update, updatePos);
+
+        Node* node = linksOf(update[0])[0].next;
+        Link* links = node->links();
+        for(unsigned l = 0; l < m_level; ++l)
+        {
+            Link& before = linksOf(update[l])[l];
+            if(l < node->level)
+                before = Link{links[l].next, before.width + links[l].width - 1};
+            else
+                --before.width;
+        }
+
+        if(links[0].next != nullptr)
+            links[0].next->prev = node->prev;
+        else
+            tail = node->prev;
+        destroyNode(node);
+        --m_itemCount;
+        lowerLevel();
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::rebuild(Node* first)
+    {
+        Node* last[MAX_LEVEL];
+        size_t lastPos[MAX_LEVEL];
+        unsigned top = 1;
+        std::fill(last, last + MAX_LEVEL, nullptr);
+        std::fill(lastPos, lastPos + MAX_LEVEL, 0);
+
+        size_t pos = 0;
+        Node* prev = nullptr;
+        for(Node* node = first; node != nullptr;)
+        {
+            Node* next = node->links()[0].next;        ///read before level 0 is rewritten
+            ++pos;
+            node->prev = prev;
+            top = std::max<unsigned>(top, node->level);
+            for(unsigned l = 0; l < node->level; ++l)
+            {
+                linksOf(last[l])[l] = Link{node, pos - lastPos[l]};
+                last[l] = node;
+                lastPos[l] = pos;
+            }
+            prev = node;
+            node = next;
+        }
+        m_itemCount = pos;
+        m_level = top;
+        for(unsigned l = 0; l < m_level; ++l)
+            linksOf(last[l])[l] = Link{nullptr, m_itemCount + 1 - lastPos[l]};
+        tail = prev;
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::takeFrom(IndexableSkipList& src)
+    {
+        std::copy(src.headLinks, src.headLinks + src.m_level, headLinks);
+        m_level = src.m_level;
+        m_itemCount = src.m_itemCount;
+        tail = src.tail;
+        src.headLinks[0] = Link{nullptr, 1};
+        src.m_level = 1;
+        src.m_itemCount = 0;
+        src.tail = nullptr;
+    }
+
+    template<typename T>
+    IndexableSkipList<T>::IndexableSkipList(std::initializer_list<T> list) : IndexableSkipList()
+    {
+        try
+        {
+            for(const T& item : list)
+            {
+                push_back(item);
+            }
+        }
+        catch(...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename T>
+    IndexableSkipList<T>::IndexableSkipList(const IndexableSkipList& src) : IndexableSkipList()
+    {
+        try
+        {
+            for(Node* node = src.headLinks[0].next; node != nullptr; node = node->links()[0].next)
+            {
+                push_back(node->value());
+            }
+        }
+        catch(...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename T>
+    IndexableSkipList<T>& IndexableSkipList<T>::operator=(const IndexableSkipList& rhs)
+    {
+        if(this == &rhs)
+            return *this;
+        IndexableSkipList tmp{rhs};
+        clear();
+        takeFrom(tmp);
+        return *this;
+    }
+
+    template<typename T>
+    IndexableSkipList<T>::IndexableSkipList(IndexableSkipList&& src) noexcept
+    {
+        takeFrom(src);
+    }
+
+    template<typename T>
+    IndexableSkipList<T>& IndexableSkipList<T>::operator=(IndexableSkipList&& rhs) noexcept
+    {
+        if(this == &rhs)
+            return *this;
+        clear();
+        takeFrom(rhs);
+        return *this;
+    }
+
+    template<typename T>
+    template<typename U>
+    void IndexableSkipList<T>::push_back(U&& value)
+    {
+        insertAt(m_itemCount, std::forward<U>(value));
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::pop_back()
+    {
+        if(!isempty())
+            removeAt(m_itemCount - 1);
+    }
+
+    template<typename T>
+    template<typename U>
+    void IndexableSkipList<T>::push_front(U&& value)
+    {
+        insertAt(0, std::forward<U>(value));
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::pop_front()
+    {
+        if(!isempty())
+            removeAt(0);
+    }
+
+    template<typename T>
+    template<typename U>
+    void IndexableSkipList<T>::insert(size_t index, U&& value)
+    {
+        if(index != 0)
+            validRange(index);
+        insertAt(index, std::forward<U>(value));
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::remove(size_t index)
+    {
+        if(!isempty())
+        {
+            validRange(index);
+            removeAt(index);
+        }
+    }
+
+    template<typename T>
+    T& IndexableSkipList<T>::operator[](size_t index)
+    {
+        return nodeAt(index)->value();
+    }
+
+    template<typename T>
+    T& IndexableSkipList<T>::at(size_t index)
+    {
+        validRange(index);
+        return nodeAt(index)->value();
+    }
+
+    template<typename T>
+    IndexableSkipList<T> IndexableSkipList<T>::split_at(size_t index)
+    {
+        if(index > m_itemCount)
+        {
+            throw std::range_error("index is out of bounds");
+        }
+        IndexableSkipList rest;
+        if(index == m_itemCount)
+            return rest;
+
+        Node* update[MAX_LEVEL];
+        size_t updatePos[MAX_LEVEL];
+        findPath(index + 1, update, updatePos);
+
+        rest.m_level = m_level;
+        for(unsigned l = 0; l < m_level; ++l)
+        {
+            Link& before = linksOf(update[l])[l];
+            rest.headLinks[l] = Link{before.next, updatePos[l] + before.width - index};
+            before = Link{nullptr, index + 1 - updatePos[l]};
+        }
+        rest.m_itemCount = m_itemCount - index;
+        rest.tail = tail;
+        rest.headLinks[0].next->prev = nullptr;
+        m_itemCount = index;
+        tail = update[0];
+        lowerLevel();
+        rest.lowerLevel();
+        return rest;
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::append(IndexableSkipList&& rhs)
+    {
+        if(this == &rhs || rhs.isempty())
+            return;
+        raiseLevel(rhs.m_level);
+        rhs.raiseLevel(m_level);
+
+        Node* current = nullptr;                        ///last node of every level, found top down
+        size_t pos = 0;
+        for(unsigned l = m_level; l-- > 0;)
+        {
+            Link* links = linksOf(current);
+            while(links[l].next != nullptr)
+            {
+                pos += links[l].width;
+                current = links[l].next;
+                links = current->links();
+            }
+            links[l] = Link{rhs.headLinks[l].next, m_itemCount + rhs.headLinks[l].width - pos};
+        }
+        rhs.headLinks[0].next->prev = tail;
+        tail = rhs.tail;
+        m_itemCount += rhs.m_itemCount;
+
+        rhs.headLinks[0] = Link{nullptr, 1};
+        rhs.m_level = 1;
+        rhs.m_itemCount = 0;
+        rhs.tail = nullptr;
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::reverse()
+    {
+        Node* first = tail;
+        for(Node* node = tail; node != nullptr; node = node->prev)
+            node->links()[0].next = node->prev;        ///rebuild reads level 0 before rewriting it
+        rebuild(first);
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::merge(IndexableSkipList&& rhs)
+    {
+        if(this == &rhs || rhs.isempty())
+            return;
+        Node* a = headLinks[0].next;
+        Node* b = rhs.headLinks[0].next;
+        Node* first = nullptr;
+        Node** link = &first;
+        while(a != nullptr && b != nullptr)
+        {
+            Node*& taken = b->value() < a->value() ? b : a;
+            *link = taken;
+            link = &taken->links()[0].next;
+            taken = taken->links()[0].next;
+        }
+        *link = a != nullptr ? a : b;
+
+        rhs.headLinks[0] = Link{nullptr, 1};
+        rhs.m_level = 1;
+        rhs.m_itemCount = 0;
+        rhs.tail = nullptr;
+        rebuild(first);
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::sort()
+    {
+        if(m_itemCount < 2)
+            return;
+        std::vector<Node*> nodes;
+        nodes.reserve(m_itemCount);
+        for(Node* node = headLinks[0].next; node != nullptr; node = node->links()[0].next)
+            nodes.push_back(node);
+        std::stable_sort(nodes.begin(), nodes.end(), [](Node* a, Node* b) { return a->value() < b->value(); });
+        for(size_t i = 0; i + 1 < nodes.size(); ++i)
+            nodes[i]->links()[0].next = nodes[i + 1];
+        nodes.back()->links()[0].next = nullptr;
+        rebuild(nodes.front());
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::clear()
+    {
+        Node* node = headLinks[0].next;
+        while(node != nullptr)
+        {
+            Node* next = node->links()[0].next;
+            destroyNode(node);
+            node = next;
+        }
+        headLinks[0] = Link{nullptr, 1};
+        m_level = 1;
+        m_itemCount = 0;
+        tail = nullptr;
+    }
+
+    template<typename T>
+    bool IndexableSkipList<T>::isempty() const
+    {
+        return m_itemCount == 0;
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::print()
+    {
+        for(Node* node = headLinks[0].next; node != nullptr; node = node->links()[0].next)
+        {
+            std::cout << node->value() << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+    template<typename T>
+    void IndexableSkipList<T>::printFromTail()
+    {
+        for(Node* node = tail; node != nullptr; node = node->prev)
+        {
+            std::cout << node->value() << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+    template<typename T>
+    size_t IndexableSkipList<T>::size() const
+    {
+        return m_itemCount;
+    }
+}
@@ -0,0 +1,445 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "ChainSort.h"
+
+
+namespace DLL{
+    struct DefaultTag {};
+
+    template<typename T, typename Tag>
+    class IntrusiveList;
+
+    /// Links embedded in the element itself. Derive from one hook per list the
+    /// object can be on at the same time, told apart by Tag:
+    ///     struct Conn : DLL::IntrusiveHook<Idle>, DLL::IntrusiveHook<Active> {...};
+    /// Copying an object does not copy its membership. An object must be taken
+    /// off its list before it is destroyed.
+    template<typename Tag = DefaultTag>
+    class IntrusiveHook
+    {
+            template<typename, typename> friend class IntrusiveList;
+
+            IntrusiveHook* m_next{nullptr};
+            IntrusiveHook* m_prev{nullptr};
+
+        public:
+            IntrusiveHook() = default;
+            IntrusiveHook(const IntrusiveHook&) noexcept {}
+            IntrusiveHook& operator=(const IntrusiveHook&) noexcept { return *this; }
+            ~IntrusiveHook() = default;
+
+            bool isLinked() const { return m_next != nullptr; }
+    };
+
+    /// Doubly linked list of objects that carry an IntrusiveHook<Tag>. The list
+    /// never allocates or owns anything: push links the object in, pop/erase
+    /// link it out, and erase(object) is O(1) without knowing its position.
+    /// Circular around a sentinel, so no operation branches on head or tail.
+    template<typename T, typename Tag = DefaultTag>
+    class IntrusiveList
+    {
+        private:
+            using Hook = IntrusiveHook<Tag>;
+            static_assert(std::is_base_of_v<Hook, T>, "T must derive from IntrusiveHook<Tag>");
+
+            Hook sentinel;
+            size_t m_itemCount{0};
+
+            static T& owner(Hook* hook) { return static_cast<T&>(*hook); }
+            static Hook* hookOf(T& object) { return static_cast<Hook*>(&object); }
+
+            void resetSentinel();
+            void linkBefore(Hook* pos, Hook* hook);
+            void unlinkHook(Hook* hook);
+            void takeFrom(IntrusiveList& src);
+            void validRange(size_t index) const;
+            Hook* hookAt(size_t index);
+
+            static Hook*& nextOf(Hook* hook) { return hook->m_next; }          ///link for chain::sort
+
+            template<bool Const>
+            class Iterator
+            {
+                    friend class IntrusiveList;
+                    template<bool> friend class Iterator;
+                    using HookPtr = std::conditional_t<Const, const Hook*, Hook*>;
+
+                    HookPtr hook{nullptr};
+
+                    explicit Iterator(HookPtr hook) : hook{hook} {}
+
+                public:
+                    using iterator_category = std::bidirectional_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = std::conditional_t<Const, const T*, T*>;
+                    using reference = std::conditional_t<Const, const T&, T&>;
+
+                    Iterator() = default;
+                    operator Iterator<true>() const { return Iterator<true>{hook}; }
+
+                    reference operator*() const { return static_cast<reference>(*hook); }
+                    pointer operator->() const { return &**this; }
+                    Iterator& operator++() { hook = hook->m_next; return *this; }
+                    Iterator operator++(int) { Iterator old{*this}; hook = hook->m_next; return old; }
+                    Iterator& operator--() { hook = hook->m_prev; return *this; }
+                    Iterator operator--(int) { Iterator old{*this}; hook = hook->m_prev; return old; }
+                    bool operator==(const Iterator& rhs) const { return hook == rhs.hook; }
+                    bool operator!=(const Iterator& rhs) const { return hook != rhs.hook; }
+            };
+
+        public:
+            using iterator = Iterator<false>;
+            using const_iterator = Iterator<true>;
+
+            IntrusiveList();
+            IntrusiveList(const IntrusiveList&) = delete;
+            IntrusiveList& operator=(const IntrusiveList&) = delete;
+            IntrusiveList(IntrusiveList&& src) noexcept;
+            IntrusiveList& operator=(IntrusiveList&& rhs) noexcept;
+            ~IntrusiveList(){clear();}
+
+            void push_back(T& object);                  ////////////////  TC O(1)
+            void pop_back();
+            void push_front(T& object);                 ////////////////  TC O(1)
+            void pop_front();
+            void insert(size_t index, T& object);       ////////////////  TC O(n)
+            iterator insert(const_iterator pos, T& object);   /// before pos, TC O(1)
+            void remove(size_t index);                  ////////////////  TC O(n)
+            void erase(T& object);                      ////////////////  TC O(1), object must be on this list
+            void reverse();
+            void merge(IntrusiveList&& rhs);            /// both sorted; stable, rhs ends empty
+            template<typename Compare = std::less<>>
+            void merge(IntrusiveList&& rhs, Compare comp);
+            template<typename Compare = std::less<>>
+            void sort(Compare comp = Compare{});        /// bottom-up natural merge sort, O(1) space
+            void clear();                               /// unlinks every object, TC O(n)
+
+            T& front();
+            T& back();
+            static iterator iteratorTo(T& object);      /// object must be on a list
+
+            iterator begin() { return iterator{sentinel.m_next}; }
+            iterator end() { return iterator{&sentinel}; }
+            const_iterator begin() const { return const_iterator{sentinel.m_next}; }
+            const_iterator end() const { return const_iterator{&sentinel}; }
+
+            bool isempty() const;
+            void print() const;
+            void printFromTail() const;
+            size_t size() const;
+    };
+
+    template<typename T, typename Tag>
+    IntrusiveList<T, Tag>::IntrusiveList()
+    {
+        resetSentinel();
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::resetSentinel()
+    {
+        sentinel.m_next = sentinel.m_prev = &sentinel;
+        m_itemCount = 0;
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::takeFrom(IntrusiveList& src)
+    {
+        if(src.isempty())
+        {
+            resetSentinel();
+            return;
+        }
+        sentinel.m_next = src.sentinel.m_next;
+        sentinel.m_prev = src.sentinel.m_prev;
+        sentinel.m_next->m_prev = &sentinel;
+        sentinel.m_prev->m_next = &sentinel;
+        m_itemCount = src.m_itemCount;
+        src.resetSentinel();
+    }
+
+    template<typename T, typename Tag>
+    IntrusiveList<T, Tag>::IntrusiveList(IntrusiveList&& src) noexcept
+    {
+        takeFrom(src);
+    }
+
+    template<typename T, typename Tag>
+    IntrusiveList<T, Tag>& IntrusiveList<T, Tag>::operator=(IntrusiveList&& rhs) noexcept
+    {
+        if(this == &rhs)
+            return *this;
+        clear();
+        takeFrom(rhs);
+        return *this;
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::linkBefore(Hook* pos, Hook* hook)
+    {
+        if(hook->isLinked())
+        {
+            throw std::logic_error("object is already on a list");
+        }
+        hook->m_next = pos;
+        hook->m_prev = pos->m_prev;
+        pos->m_prev->m_next = hook;
+        pos->m_prev = hook;
+        ++m_itemCount;
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::unlinkHook(Hook* hook)
+    {
+        hook->m_prev->m_next = hook->m_next;
+        hook->m_next->m_prev = hook->m_prev;
+        hook->m_next = hook->m_prev = nullptr;
+        --m_itemCount;
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::validRange(size_t index) const
+    {
+        if(index >= m_itemCount)
+        {
+            throw std::range_error("index is out of bounds");
+        }
+    }
+
+    template<typename T, typename Tag>
+    typename IntrusiveList<T, Tag>::Hook* IntrusiveList<T, Tag>::hookAt(size_t index)
+    {
+        Hook* current;
+        if(index < m_itemCount / 2)
+        {
+            current = sentinel.m_next;
+            for(; index != 0; --index)
+                current = current->m_next;
+        }
+        else
+        {
+            current = sentinel.m_prev;
+            for(index = m_itemCount - 1 - index; index != 0; --index)
+                current = current->m_prev;
+        }
+        return current;
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::push_back(T& object)
+    {
+        linkBefore(&sentinel, hookOf(object));
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::pop_back()
+    {
+        if(!isempty())
+            unlinkHook(sentinel.m_prev);
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::push_front(T& object)
+    {
+        linkBefore(sentinel.m_next, hookOf(object));
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::pop_front()
+    {
+        if(!isempty())
+            unlinkHook(sentinel.m_next);
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::insert(size_t index, T& object)
+    {
+        if(index == 0)
+        {
+            push_front(object);
+            return;
+        }
+        validRange(index);
+        linkBefore(hookAt(index), hookOf(object));
+    }
+
+    template<typename T, typename Tag>
+    typename IntrusiveList<T, Tag>::iterator IntrusiveList<T, Tag>::insert(const_iterator pos, T& object)
+    {
+        linkBefore(const_cast<Hook*>(pos.hook), hookOf(object));
+        return iterator{hookOf(object)};
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::remove(size_t index)
+    {
+        if(!isempty())
+        {
+            validRange(index);
+            unlinkHook(hookAt(index));
+        }
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::erase(T& object)
+    {
+        Hook* hook = hookOf(object);
+        if(!hook->isLinked())
+        {
+            throw std::logic_error("object is not on a list");
+        }
+        unlinkHook(hook);
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::reverse()
+    {
+        Hook* current = &sentinel;
+        do
+        {
+            std::swap(current->m_next, current->m_prev);
+            current = current->m_prev;                  ///the old next
+        }
+        while(current != &sentinel);
+    }
+
+    template<typename T, typename Tag>
+    template<typename Compare>
+    void IntrusiveList<T, Tag>::sort(Compare comp)
+    {
+        if(m_itemCount < 2)
+            return;
+
+        sentinel.m_prev->m_next = nullptr;              ///work on a null-terminated chain
+        auto less = [&comp](Hook* a, Hook* b) { return comp(owner(a), owner(b)); };
+        Hook* last = nullptr;
+        Hook* result = chain::sort(sentinel.m_next, last, nextOf, less);
+
+        Hook* prev = &sentinel;                         ///one pass restores m_prev and closes the ring
+        for(Hook* current = result; current != nullptr; current = current->m_next)
+        {
+            current->m_prev = prev;
+            prev->m_next = current;
+            prev = current;
+        }
+        prev->m_next = &sentinel;
+        sentinel.m_prev = prev;
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::merge(IntrusiveList&& rhs)
+    {
+        merge(std::move(rhs), std::less<>{});
+    }
+
+    template<typename T, typename Tag>
+    template<typename Compare>
+    void IntrusiveList<T, Tag>::merge(IntrusiveList&& rhs, Compare comp)
+    {
+        if(this == &rhs || rhs.isempty())
+            return;
+        Hook* left = sentinel.m_next;
+        Hook* right = rhs.sentinel.m_next;
+        while(left != &sentinel && right != &rhs.sentinel)
+        {
+            if(comp(owner(right), owner(left)))
+            {
+                Hook* next = right->m_next;
+                right->m_prev = left->m_prev;           ///splice right in before left
+                right->m_next = left;
+                left->m_prev->m_next = right;
+                left->m_prev = right;
+                right = next;
+            }
+            else
+            {
+                left = left->m_next;
+            }
+        }
+        if(right != &rhs.sentinel)                      ///the rest of rhs goes after our last
+        {
+            Hook* lastRight = rhs.sentinel.m_prev;
+            right->m_prev = sentinel.m_prev;
+            sentinel.m_prev->m_next = right;
+            lastRight->m_next = &sentinel;
+            sentinel.m_prev = lastRight;
+        }
+        m_itemCount += rhs.m_itemCount;
+        rhs.resetSentinel();
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::clear()
+    {
+        Hook* current = sentinel.m_next;
+        while(current != &sentinel)
+        {
+            Hook* next = current->m_next;
+            current->m_next = current->m_prev = nullptr;
+            current = next;
+        }
+        resetSentinel();
+    }
+
+    template<typename T, typename Tag>
+    T& IntrusiveList<T, Tag>::front()
+    {
+        if(isempty())
+            throw std::range_error("list is empty");
+        return owner(sentinel.m_next);
+    }
+
+    template<typename T, typename Tag>
+    T& IntrusiveList<T, Tag>::back()
+    {
+        if(isempty())
+            throw std::range_error("list is empty");
+        return owner(sentinel.m_prev);
+    }
+
+    template<typename T, typename Tag>
+    typename IntrusiveList<T, Tag>::iterator IntrusiveList<T, Tag>::iteratorTo(T& object)
+    {
+        return iterator{hookOf(object)};
+    }
+
+    template<typename T, typename Tag>
+    bool IntrusiveList<T, Tag>::isempty() const
+    {
+        return m_itemCount == 0;
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::print() const
+    {
+        for(const T& item : *this)
+        {
+            std::cout << item << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+    template<typename T, typename Tag>
+    void IntrusiveList<T, Tag>::printFromTail() const
+    {
+        for(const Hook* current = sentinel.m_prev; current != &sentinel; current = current->m_prev)
+        {
+            std::cout << static_cast<const T&>(*current) << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+    template<typename T, typename Tag>
+    size_t IntrusiveList<T, Tag>::size() const
+    {
+        return m_itemCount;
+    }
+}
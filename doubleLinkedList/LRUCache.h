@@ -0,0 +1,421 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "IntrusiveList.h"
+#include "NodePool.h"
+
+
+namespace DLL{
+    enum class CachePolicy
+    {
+        LRU,                                            /// one recency list
+        SegmentedLRU                                    /// probation + protected; a second hit promotes
+    };
+
+    /// Default entry size for byte capacities: the footprint of key and value.
+    struct EntryBytes
+    {
+        template<typename K, typename V>
+        size_t operator()(const K&, const V&) const { return sizeof(K) + sizeof(V); }
+    };
+
+    /// Least-recently-used cache. Entries live in a NodePool and sit on
+    /// IntrusiveLists ordered most recent first, so a hit is an O(1) unlink and
+    /// relink and eviction takes the list tail. Keys are found through an
+    /// open-addressing table (linear probing, backward-shift deletion) of entry
+    /// pointers with their cached hashes.
+    /// The cache is bounded by entry count, by total weight in bytes, or both.
+    /// Not thread-safe.
+    template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>, typename Weigher = EntryBytes>
+    class LRUCache
+    {
+        public:
+            struct Stats
+            {
+                uint64_t hits{0};
+                uint64_t misses{0};
+                uint64_t insertions{0};
+                uint64_t evictions{0};
+            };
+
+        private:
+            struct Entry : IntrusiveHook<>
+            {
+                K key;
+                V value;
+                size_t bytes;
+                bool isProtected{false};
+
+                template<typename U>
+                Entry(const K& key, U&& value, size_t bytes) : key(key), value(std::forward<U>(value)), bytes{bytes} {}
+            };
+            struct Slot
+            {
+                Entry* entry{nullptr};
+                uint64_t hash{0};
+            };
+            struct Segment
+            {
+                IntrusiveList<Entry> list;                      /// most recent first
+                size_t bytes{0};
+            };
+
+            static constexpr size_t NPOS = SIZE_MAX;
+
+            std::vector<Slot> table;
+            unsigned shift{64};                                 /// home slot = hash >> shift
+            NodePool<Entry> entries;
+            Segment probation;                                  /// the only segment under plain LRU
+            Segment protectedSegment;
+            size_t count{0};
+            size_t maxEntries;
+            size_t maxBytes;
+            size_t protectedEntries;
+            size_t protectedBytes;
+            CachePolicy policy;
+            Hash hasher;
+            KeyEqual equal;
+            Weigher weigher;
+            Stats m_stats;
+
+            uint64_t hashOf(const K& key) const;
+            size_t home(uint64_t hash) const { return static_cast<size_t>(hash >> shift); }
+            size_t findSlot(const K& key, uint64_t hash) const;
+            void insertSlot(Entry* entry, uint64_t hash);
+            void eraseSlot(size_t index);
+            void rehash(size_t slots);
+
+            Segment& segmentOf(Entry* entry) { return entry->isProtected ? protectedSegment : probation; }
+            void link(Segment& segment, Entry* entry);          /// at the front
+            void unlink(Entry* entry);
+            void touch(Entry* entry);                           /// records a hit
+            void shrinkProtected();                             /// demotes protected tails to probation
+            void evictOver(const Entry* keep);                  /// evicts until both limits hold, never keep
+            void destroy(Entry* entry);                         /// out of the table, the lists and the pool
+
+        public:
+            explicit LRUCache(size_t maxEntries, size_t maxBytes = SIZE_MAX, CachePolicy policy = CachePolicy::LRU,
+                              double protectedShare = 0.8, const Hash& hash = Hash{}, const KeyEqual& keyEqual = KeyEqual{},
+                              const Weigher& weigher = Weigher{});
+
+            LRUCache(const LRUCache&) = delete;
+            LRUCache& operator=(const LRUCache&) = delete;
+            ~LRUCache(){clear();}
+
+            V* get(const K& key);                               ////////////////  TC O(1) expected, refreshes recency
+            const V* peek(const K& key) const;                  ////////////////  TC O(1) expected, no recency change
+            bool contains(const K& key) const;
+            template<typename U>
+            bool put(const K& key, U&& value);                  /// false when the entry alone is over maxBytes
+            bool erase(const K& key);
+            void clear();
+
+            size_t size() const;
+            bool isEmpty() const;
+            size_t bytes() const;
+            size_t entryCapacity() const;
+            size_t byteCapacity() const;
+            const Stats& stats() const;
+            void resetStats();
+    };
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    LRUCache<K, V, Hash, KeyEqual, Weigher>::LRUCache(size_t maxEntries, size_t maxBytes, CachePolicy policy, double protectedShare,
+                                                      const Hash& hash, const KeyEqual& keyEqual, const Weigher& weigher)
+                        : maxEntries{maxEntries},
+                          maxBytes{maxBytes},
+                          protectedEntries{0},
+                          protectedBytes{0},
+                          policy{policy},
+                          hasher{hash},
+                          equal{keyEqual},
+                          weigher{weigher}
+    {
+        if(maxEntries == 0 || maxBytes == 0)
+            throw std::invalid_argument("cache capacity must be positive");
+        if(policy == CachePolicy::SegmentedLRU)
+        {
+            if(!(protectedShare > 0.0 && protectedShare < 1.0))
+                throw std::invalid_argument("protected share must be between 0 and 1");
+            protectedEntries = maxEntries == SIZE_MAX ? SIZE_MAX : static_cast<size_t>(maxEntries * protectedShare);
+            protectedBytes = maxBytes == SIZE_MAX ? SIZE_MAX : static_cast<size_t>(maxBytes * protectedShare);
+        }
+        size_t expected = std::min<size_t>(maxEntries, 1 << 16);        ///small bounded caches never rehash
+        rehash(std::bit_ceil(expected + expected / 2 + 1));
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    uint64_t LRUCache<K, V, Hash, KeyEqual, Weigher>::hashOf(const K& key) const
+    {
+        return static_cast<uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull;     ///Fibonacci mix, std::hash is often the identity
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    size_t LRUCache<K, V, Hash, KeyEqual, Weigher>::findSlot(const K& key, uint64_t hash) const
+    {
+        const size_t mask = table.size() - 1;
+        for(size_t i = home(hash); table[i].entry != nullptr; i = (i + 1) & mask)
+        {
+            if(table[i].hash == hash && equal(table[i].entry->key, key))
+                return i;
+        }
+        return NPOS;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::insertSlot(Entry* entry, uint64_t hash)
+    {
+        const size_t mask = table.size() - 1;
+        size_t i = home(hash);
+        while(table[i].entry != nullptr)
+            i = (i + 1) & mask;
+        table[i] = Slot{entry, hash};
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::eraseSlot(size_t index)
+    {
+        const size_t mask = table.size() - 1;
+        size_t hole = index;
+        for(size_t i = (hole + 1) & mask; table[i].entry != nullptr; i = (i + 1) & mask)
+        {
+            size_t distance = (i - home(table[i].hash)) & mask;            ///probe length of the slot at i
+            if(distance >= ((i - hole) & mask))                             ///its home is at or before the hole
+            {
+                table[hole] = table[i];
+                hole = i;
+            }
+        }
+        table[hole] = Slot{};
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::rehash(size_t slots)
+    {
+        std::vector<Slot> old(slots);
+        old.swap(table);
+        shift = 64 - std::countr_zero(slots);
+        for(const Slot& slot : old)
+        {
+            if(slot.entry != nullptr)
+                insertSlot(slot.entry, slot.hash);
+        }
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::link(Segment& segment, Entry* entry)
+    {
+        entry->isProtected = &segment == &protectedSegment;
+        segment.list.push_front(*entry);
+        segment.bytes += entry->bytes;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::unlink(Entry* entry)
+    {
+        Segment& segment = segmentOf(entry);
+        segment.list.erase(*entry);
+        segment.bytes -= entry->bytes;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::touch(Entry* entry)
+    {
+        unlink(entry);
+        if(policy == CachePolicy::SegmentedLRU)
+        {
+            link(protectedSegment, entry);
+            shrinkProtected();
+        }
+        else
+        {
+            link(probation, entry);
+        }
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::shrinkProtected()
+    {
+        while(protectedSegment.list.size() > 1 &&
+              (protectedSegment.list.size() > protectedEntries || protectedSegment.bytes > protectedBytes))
+        {
+            Entry* demoted = &protectedSegment.list.back();
+            unlink(demoted);
+            link(probation, demoted);
+        }
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::evictOver(const Entry* keep)
+    {
+        while(count > maxEntries || probation.bytes + protectedSegment.bytes > maxBytes)
+        {
+            Segment* victims = probation.list.isempty() || &probation.list.back() == keep ? &protectedSegment : &probation;
+            if(victims->list.isempty() || &victims->list.back() == keep)   ///keep fits on its own, so this is never hit
+                victims = &probation;
+            destroy(&victims->list.back());
+            ++m_stats.evictions;
+        }
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::destroy(Entry* entry)
+    {
+        eraseSlot(findSlot(entry->key, hashOf(entry->key)));
+        unlink(entry);
+        entry->~Entry();
+        entries.deallocate(entry);
+        --count;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    V* LRUCache<K, V, Hash, KeyEqual, Weigher>::get(const K& key)
+    {
+        size_t index = findSlot(key, hashOf(key));
+        if(index == NPOS)
+        {
+            ++m_stats.misses;
+            return nullptr;
+        }
+        ++m_stats.hits;
+        Entry* entry = table[index].entry;
+        touch(entry);
+        return &entry->value;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    const V* LRUCache<K, V, Hash, KeyEqual, Weigher>::peek(const K& key) const
+    {
+        size_t index = findSlot(key, hashOf(key));
+        return index == NPOS ? nullptr : &table[index].entry->value;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    bool LRUCache<K, V, Hash, KeyEqual, Weigher>::contains(const K& key) const
+    {
+        return findSlot(key, hashOf(key)) != NPOS;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    template<typename U>
+    bool LRUCache<K, V, Hash, KeyEqual, Weigher>::put(const K& key, U&& value)
+    {
+        const uint64_t hash = hashOf(key);
+        const size_t bytes = weigher(key, value);
+        size_t index = findSlot(key, hash);
+        if(bytes > maxBytes)
+        {
+            if(index != NPOS)
+                destroy(table[index].entry);            ///the stale value must not survive a failed update
+            return false;
+        }
+
+        Entry* entry = nullptr;
+        if(index != NPOS)                               ///update in place, counts as a use
+        {
+            entry = table[index].entry;
+            entry->value = std::forward<U>(value);
+            segmentOf(entry).bytes += bytes - entry->bytes;
+            entry->bytes = bytes;
+            touch(entry);
+        }
+        else
+        {
+            if((count + 1) * 3 > table.size() * 2)      ///keep the load under 2/3
+                rehash(table.size() * 2);
+            void* memory = entries.allocate();
+            try
+            {
+                entry = new (memory) Entry{key, std::forward<U>(value), bytes};
+            }
+            catch(...)
+            {
+                entries.deallocate(memory);
+                throw;
+            }
+            insertSlot(entry, hash);
+            link(probation, entry);
+            ++count;
+            ++m_stats.insertions;
+        }
+        evictOver(entry);                               ///makes room around the entry, even if it is probation's only one
+        return true;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    bool LRUCache<K, V, Hash, KeyEqual, Weigher>::erase(const K& key)
+    {
+        size_t index = findSlot(key, hashOf(key));
+        if(index == NPOS)
+            return false;
+        destroy(table[index].entry);
+        return true;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::clear()
+    {
+        for(Segment* segment : {&probation, &protectedSegment})
+        {
+            while(!segment->list.isempty())
+            {
+                Entry* entry = &segment->list.front();
+                segment->list.pop_front();
+                entry->~Entry();
+            }
+            segment->bytes = 0;
+        }
+        entries.reset();                                ///every slab is free again
+        std::fill(table.begin(), table.end(), Slot{});
+        count = 0;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    size_t LRUCache<K, V, Hash, KeyEqual, Weigher>::size() const
+    {
+        return count;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    bool LRUCache<K, V, Hash, KeyEqual, Weigher>::isEmpty() const
+    {
+        return count == 0;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    size_t LRUCache<K, V, Hash, KeyEqual, Weigher>::bytes() const
+    {
+        return probation.bytes + protectedSegment.bytes;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    size_t LRUCache<K, V, Hash, KeyEqual, Weigher>::entryCapacity() const
+    {
+        return maxEntries;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    size_t LRUCache<K, V, Hash, KeyEqual, Weigher>::byteCapacity() const
+    {
+        return maxBytes;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    const typename LRUCache<K, V, Hash, KeyEqual, Weigher>::Stats& LRUCache<K, V, Hash, KeyEqual, Weigher>::stats() const
+    {
+        return m_stats;
+    }
+
+    template<typename K, typename V, typename Hash, typename KeyEqual, typename Weigher>
+    void LRUCache<K, V, Hash, KeyEqual, Weigher>::resetStats()
+    {
+        m_stats = Stats{};
+    }
+}
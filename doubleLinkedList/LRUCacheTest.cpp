@@ -0,0 +1,53 @@
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include "LRUCache.h"
+
+/// Self-checking scenarios for LRUCache's byte limit under SegmentedLRU.
+///   LRUCacheTest      - exits non-zero (assert) on the first failure
+
+namespace
+{
+    struct TextBytes
+    {
+        size_t operator()(const int&, const std::string& text) const { return text.size(); }
+    };
+    using Cache = DLL::LRUCache<int, std::string, std::hash<int>, std::equal_to<int>, TextBytes>;
+
+    void newEntryAloneInProbation()
+    {
+        Cache cache(100, 100, DLL::CachePolicy::SegmentedLRU, 0.8);
+        for(int key = 0; key < 8; ++key)
+        {
+            assert(cache.put(key, std::string(10, 'a')));
+            assert(cache.get(key) != nullptr);                  ///promoted, probation ends empty
+        }
+        assert(cache.bytes() == 80);
+
+        assert(cache.put(99, std::string(30, 'b')));            ///room comes out of protected
+        assert(cache.contains(99));
+        assert(cache.size() == 8 && cache.bytes() == 100);
+        assert(!cache.contains(0) && cache.contains(7));        ///protected's least recent went first
+    }
+
+    void updateGrowsPastLimit()
+    {
+        Cache cache(100, 100, DLL::CachePolicy::SegmentedLRU, 0.8);
+        for(int key = 0; key < 5; ++key)
+            assert(cache.put(key, std::string(20, 'a')));
+        assert(cache.put(2, std::string(60, 'c')));             ///update, now the only protected entry
+        assert(cache.contains(2) && cache.peek(2)->size() == 60);
+        assert(cache.bytes() <= 100);
+
+        assert(!cache.put(3, std::string(101, 'd')));           ///alone over maxBytes
+        assert(!cache.contains(3));
+    }
+}
+
+int main()
+{
+    newEntryAloneInProbation();
+    updateGrowsPastLimit();
+    std::printf("LRUCache: all checks passed\n");
+    return 0;
+}
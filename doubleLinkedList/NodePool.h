@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace DLL{
+    /// Slab allocator for fixed-size list nodes. Slabs grow geometrically and are
+    /// only released with the pool; freed nodes go on an intrusive free list.
+    /// A pool can be shared by several lists through std::shared_ptr. Not thread-safe.
+    template<typename Node>
+    class NodePool
+    {
+        private:
+            union Slot
+            {
+                Slot* next;
+                alignas(Node) unsigned char storage[sizeof(Node)];
+            };
+
+            static constexpr size_t FIRST_SLAB = 64;
+            static constexpr size_t MAX_SLAB = 8192;
+
+            std::vector<std::unique_ptr<Slot[]>> slabs;
+            std::vector<size_t> slabSizes;
+            size_t currentSlab{0};                                  /// bump allocation happens here
+            size_t used{0};                                         /// slots handed out from slabs[currentSlab]
+            Slot* freeList{nullptr};
+            size_t live{0};
+
+        public:
+            NodePool() = default;
+            NodePool(const NodePool&) = delete;
+            NodePool& operator=(const NodePool&) = delete;
+            ~NodePool() = default;
+
+            void* allocate();                                       ////////////////  TC O(1) amortized
+            void deallocate(void* node) noexcept;                   ////////////////  TC O(1)
+            void reset() noexcept;                                  /// every node is dead; rewinds to the first slab
+
+            size_t liveNodes() const { return live; }
+            size_t slabCount() const { return slabs.size(); }
+    };
+
+    template<typename Node>
+    void* NodePool<Node>::allocate()
+    {
+        if(freeList != nullptr)
+        {
+            Slot* slot = freeList;
+            freeList = slot->next;
+            ++live;
+            return slot;
+        }
+        while(currentSlab < slabs.size() && used == slabSizes[currentSlab])
+        {
+            ++currentSlab;
+            used = 0;
+        }
+        if(currentSlab == slabs.size())
+        {
+            size_t nodes = slabSizes.empty() ? FIRST_SLAB : std::min(slabSizes.back() * 2, MAX_SLAB);
+            slabs.emplace_back(new Slot[nodes]);
+            slabSizes.push_back(nodes);
+            used = 0;
+        }
+        ++live;
+        return &slabs[currentSlab][used++];
+    }
+
+    template<typename Node>
+    void NodePool<Node>::deallocate(void* node) noexcept
+    {
+        Slot* slot = static_cast<Slot*>(node);
+        slot->next = freeList;
+        freeList = slot;
+        --live;
+    }
+
+    template<typename Node>
+    void NodePool<Node>::reset() noexcept
+    {
+        currentSlab = 0;
+        used = 0;
+        freeList = nullptr;
+        live = 0;
+    }
+}
@@ -0,0 +1,592 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace DLL{
+    /// Unrolled doubly linked list - same interface as Dll, but every node holds a
+    /// small array of elements sized so one node fills BlockBytes (a cache line or
+    /// a few). Scans walk contiguous arrays and pay one pointer chase per block.
+    /// Full blocks split in half on insert; blocks that drop below half merge
+    /// with a neighbour on remove.
+    template<typename T, size_t BlockBytes = 256>
+    class UnrolledDll
+    {
+        private:
+            static constexpr size_t HEADER = (2 * sizeof(void*) + sizeof(uint32_t) + alignof(T) - 1) / alignof(T) * alignof(T);
+            static constexpr size_t CAPACITY = std::max<size_t>(2, BlockBytes > HEADER ? (BlockBytes - HEADER) / sizeof(T) : 0);
+            static constexpr size_t BLOCK_ALIGN = std::max<size_t>(alignof(T), BlockBytes % 64 == 0 ? 64 : alignof(void*));
+
+            struct alignas(BLOCK_ALIGN) Block
+            {
+                Block* m_next{nullptr};
+                Block* m_prev{nullptr};
+                uint32_t m_count{0};
+                alignas(T) unsigned char m_storage[CAPACITY * sizeof(T)];
+
+                T* data() { return std::launder(reinterpret_cast<T*>(m_storage)); }
+                const T* data() const { return std::launder(reinterpret_cast<const T*>(m_storage)); }
+                bool isFull() const { return m_count == CAPACITY; }
+            };
+
+            size_t m_itemCount{0};
+            Block* head{nullptr};
+            Block* tail{nullptr};
+
+            void validRange(size_t index) const;
+            std::pair<Block*, size_t> locate(size_t index) const;     ///walks from the closer end
+            Block* linkBlockAfter(Block* block);                        ///nullptr = new head
+            void unlinkBlock(Block* block);                             ///block must be empty
+            template<typename U>
+            void emplaceIn(Block* block, size_t pos, U&& value);        ///block must not be full
+            void eraseIn(Block* block, size_t pos);
+            void moveAll(Block* from, Block* to);                       ///appends from's elements to to
+            void split(Block* block);
+            void rebalance(Block* block);
+
+            template<bool Const>
+            class Iterator
+            {
+                    friend class UnrolledDll;
+                    template<bool> friend class Iterator;
+                    using BlockPtr = std::conditional_t<Const, const Block*, Block*>;
+
+                    BlockPtr block{nullptr};
+                    size_t pos{0};
+                    const UnrolledDll* list{nullptr};
+
+                    Iterator(BlockPtr block, size_t pos, const UnrolledDll* list) : block{block}, pos{pos}, list{list} {}
+
+                public:
+                    using iterator_category = std::bidirectional_iterator_tag;
+                    using value_type = T;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = std::conditional_t<Const, const T*, T*>;
+                    using reference = std::conditional_t<Const, const T&, T&>;
+
+                    Iterator() = default;
+                    operator Iterator<true>() const { return {block, pos, list}; }
+
+                    reference operator*() const { return block->data()[pos]; }
+                    pointer operator->() const { return block->data() + pos; }
+                    Iterator& operator++()
+                    {
+                        if(++pos == block->m_count)
+                        {
+                            block = block->m_next;
+                            pos = 0;
+                        }
+                        return *this;
+                    }
+                    Iterator operator++(int) { Iterator old{*this}; ++*this; return old; }
+                    Iterator& operator--()
+                    {
+                        if(block == nullptr)
+                            block = list->tail;
+                        else if(pos == 0)
+                            block = block->m_prev;
+                        else
+                        {
+                            --pos;
+                            return *this;
+                        }
+                        pos = block->m_count - 1;
+                        return *this;
+                    }
+                    Iterator operator--(int) { Iterator old{*this}; --*this; return old; }
+                    bool operator==(const Iterator& rhs) const { return block == rhs.block && pos == rhs.pos; }
+                    bool operator!=(const Iterator& rhs) const { return !(*this == rhs); }
+            };
+
+        public:
+            using iterator = Iterator<false>;
+            using const_iterator = Iterator<true>;
+
+            UnrolledDll() = default;
+            UnrolledDll(std::initializer_list<T> list);
+            UnrolledDll(const UnrolledDll& src);
+            UnrolledDll& operator=(const UnrolledDll& rhs);
+            UnrolledDll(UnrolledDll&& src) noexcept;
+            UnrolledDll& operator=(UnrolledDll&& rhs) noexcept;
+            ~UnrolledDll(){clear();}
+
+            template<typename U>
+            void push_back(U&& value);                  ////////////////  TC O(1)
+            void pop_back();
+            template<typename U>
+            void push_front(U&& value);                 ////////////////  TC O(B)
+            void pop_front();
+            template<typename U>
+            void insert(size_t index, U&& value);       ////////////////  TC O(n/B + B)
+            void remove(size_t index);                  ////////////////  TC O(n/B + B)
+            void reverse();
+            void merge(UnrolledDll&& rhs);              /// both sorted; stable, rhs ends empty
+
+            void sort();                                /// stable, through a temporary array
+            void clear();
+
+            template<typename F>
+            void forEach(F&& f);                        /// block by block - the tight loop for scans
+
+            iterator begin() { return {head, 0, this}; }
+            iterator end() { return {nullptr, 0, this}; }
+            const_iterator begin() const { return {head, 0, this}; }
+            const_iterator end() const { return {nullptr, 0, this}; }
+
+            bool isempty() const;
+            void print() const;
+            void printFromTail() const;
+            size_t size() const;
+            size_t blockCount() const;
+            static constexpr size_t blockCapacity() { return CAPACITY; }
+    };
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::validRange(size_t index) const
+    {
+        if(index >= m_itemCount)
+        {
+            throw std::range_error("index is out of bounds");
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    std::pair<typename UnrolledDll<T, BlockBytes>::Block*, size_t> UnrolledDll<T, BlockBytes>::locate(size_t index) const
+    {
+        if(index < m_itemCount / 2)
+        {
+            Block* current = head;
+            while(index >= current->m_count)
+            {
+                index -= current->m_count;
+                current = current->m_next;
+            }
+            return {current, index};
+        }
+        size_t fromBack = m_itemCount - 1 - index;
+        Block* current = tail;
+        while(fromBack >= current->m_count)
+        {
+            fromBack -= current->m_count;
+            current = current->m_prev;
+        }
+        return {current, current->m_count - 1 - fromBack};
+    }
+
+    template<typename T, size_t BlockBytes>
+    typename UnrolledDll<T, BlockBytes>::Block* UnrolledDll<T, BlockBytes>::linkBlockAfter(Block* block)
+    {
+        Block* created = new Block;
+        created->m_prev = block;
+        created->m_next = block ? block->m_next : head;
+        if(created->m_next)
+            created->m_next->m_prev = created;
+        else
+            tail = created;
+        if(block)
+            block->m_next = created;
+        else
+            head = created;
+        return created;
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::unlinkBlock(Block* block)
+    {
+        if(block->m_prev)
+            block->m_prev->m_next = block->m_next;
+        else
+            head = block->m_next;
+        if(block->m_next)
+            block->m_next->m_prev = block->m_prev;
+        else
+            tail = block->m_prev;
+        delete block;
+    }
+
+    template<typename T, size_t BlockBytes>
+    template<typename U>
+    void UnrolledDll<T, BlockBytes>::emplaceIn(Block* block, size_t pos, U&& value)
+    {
+        T* data = block->data();
+        const size_t count = block->m_count;
+        if(pos == count)
+        {
+            new (data + count) T(std::forward<U>(value));
+        }
+        else
+        {
+            T tmp(std::forward<U>(value));                                  ///may throw before anything moves
+            new (data + count) T(std::move(data[count - 1]));
+            std::move_backward(data + pos, data + count - 1, data + count);
+            data[pos] = std::move(tmp);
+        }
+        ++block->m_count;
+        ++m_itemCount;
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::eraseIn(Block* block, size_t pos)
+    {
+        T* data = block->data();
+        std::move(data + pos + 1, data + block->m_count, data + pos);
+        data[block->m_count - 1].~T();
+        --block->m_count;
+        --m_itemCount;
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::moveAll(Block* from, Block* to)
+    {
+        T* src = from->data();
+        T* dst = to->data() + to->m_count;
+        for(size_t i = 0; i < from->m_count; ++i)
+        {
+            new (dst + i) T(std::move(src[i]));
+            src[i].~T();
+        }
+        to->m_count += from->m_count;
+        from->m_count = 0;
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::split(Block* block)
+    {
+        Block* upper = linkBlockAfter(block);
+        const size_t keep = block->m_count / 2;
+        T* src = block->data();
+        T* dst = upper->data();
+        for(size_t i = keep; i < block->m_count; ++i)
+        {
+            new (dst + (i - keep)) T(std::move(src[i]));
+            src[i].~T();
+        }
+        upper->m_count = block->m_count - keep;
+        block->m_count = static_cast<uint32_t>(keep);
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::rebalance(Block* block)
+    {
+        if(block->m_count == 0)
+        {
+            unlinkBlock(block);
+            return;
+        }
+        if(block->m_count >= CAPACITY / 2)
+            return;
+        if(block->m_next && block->m_count + block->m_next->m_count <= CAPACITY)
+        {
+            Block* next = block->m_next;
+            moveAll(next, block);
+            unlinkBlock(next);
+        }
+        else if(block->m_prev && block->m_prev->m_count + block->m_count <= CAPACITY)
+        {
+            moveAll(block, block->m_prev);
+            unlinkBlock(block);
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    UnrolledDll<T, BlockBytes>::UnrolledDll(std::initializer_list<T> list)
+    {
+        try
+        {
+            for(const T& item : list)
+            {
+                push_back(item);
+            }
+        }
+        catch(...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    UnrolledDll<T, BlockBytes>::UnrolledDll(const UnrolledDll& src)
+    {
+        try
+        {
+            for(const T& item : src)
+            {
+                push_back(item);
+            }
+        }
+        catch(...)
+        {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    UnrolledDll<T, BlockBytes>& UnrolledDll<T, BlockBytes>::operator=(const UnrolledDll& rhs)
+    {
+        if(this == &rhs)
+            return *this;
+        UnrolledDll tmp{rhs};
+        std::swap(m_itemCount, tmp.m_itemCount);
+        std::swap(head, tmp.head);
+        std::swap(tail, tmp.tail);
+        return *this;
+    }
+
+    template<typename T, size_t BlockBytes>
+    UnrolledDll<T, BlockBytes>::UnrolledDll(UnrolledDll&& src) noexcept
+                    : m_itemCount{std::exchange(src.m_itemCount, 0)},
+                      head{std::exchange(src.head, nullptr)},
+                      tail{std::exchange(src.tail, nullptr)}
+    {}
+
+    template<typename T, size_t BlockBytes>
+    UnrolledDll<T, BlockBytes>& UnrolledDll<T, BlockBytes>::operator=(UnrolledDll&& rhs) noexcept
+    {
+        if(this == &rhs)
+            return *this;
+        clear();
+        m_itemCount = std::exchange(rhs.m_itemCount, 0);
+        head = std::exchange(rhs.head, nullptr);
+        tail = std::exchange(rhs.tail, nullptr);
+        return *this;
+    }
+
+    template<typename T, size_t BlockBytes>
+    template<typename U>
+    void UnrolledDll<T, BlockBytes>::push_back(U&& value)
+    {
+        if(tail == nullptr || tail->isFull())
+        {
+            linkBlockAfter(tail);
+        }
+        try
+        {
+            emplaceIn(tail, tail->m_count, std::forward<U>(value));
+        }
+        catch(...)
+        {
+            if(tail->m_count == 0)
+                unlinkBlock(tail);
+            throw;
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::pop_back()
+    {
+        if(!isempty())
+        {
+            eraseIn(tail, tail->m_count - 1);
+            if(tail->m_count == 0)
+                unlinkBlock(tail);
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    template<typename U>
+    void UnrolledDll<T, BlockBytes>::push_front(U&& value)
+    {
+        if(head == nullptr || head->isFull())
+        {
+            linkBlockAfter(nullptr);
+        }
+        try
+        {
+            emplaceIn(head, 0, std::forward<U>(value));
+        }
+        catch(...)
+        {
+            if(head->m_count == 0)
+                unlinkBlock(head);
+            throw;
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::pop_front()
+    {
+        if(!isempty())
+        {
+            eraseIn(head, 0);
+            rebalance(head);
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    template<typename U>
+    void UnrolledDll<T, BlockBytes>::insert(size_t index, U&& value)
+    {
+        if(index == 0)
+        {
+            push_front(std::forward<U>(value));
+            return;
+        }
+        validRange(index);
+        auto [block, pos] = locate(index);
+        if(pos == 0 && !block->m_prev->isFull())                        ///index > 0, so a block precedes
+        {
+            emplaceIn(block->m_prev, block->m_prev->m_count, std::forward<U>(value));
+            return;
+        }
+        if(block->isFull())
+        {
+            split(block);
+            if(pos > block->m_count)
+            {
+                pos -= block->m_count;
+                block = block->m_next;
+            }
+        }
+        emplaceIn(block, pos, std::forward<U>(value));
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::remove(size_t index)
+    {
+        if(!isempty())
+        {
+            validRange(index);
+            auto [block, pos] = locate(index);
+            eraseIn(block, pos);
+            rebalance(block);
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::reverse()
+    {
+        Block* current = head;
+        while(current != nullptr)
+        {
+            std::reverse(current->data(), current->data() + current->m_count);
+            std::swap(current->m_next, current->m_prev);
+            current = current->m_prev;
+        }
+        std::swap(head, tail);
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::merge(UnrolledDll&& rhs)
+    {
+        if(rhs.isempty() || this == &rhs)
+            return;
+        if(isempty())
+        {
+            *this = std::move(rhs);
+            return;
+        }
+
+        UnrolledDll merged;
+        iterator left = begin();
+        iterator right = rhs.begin();
+        while(left != end() && right != rhs.end())
+        {
+            if(*right < *left)
+                merged.push_back(std::move(*right++));
+            else
+                merged.push_back(std::move(*left++));
+        }
+        for(; left != end(); ++left)
+            merged.push_back(std::move(*left));
+        for(; right != rhs.end(); ++right)
+            merged.push_back(std::move(*right));
+        *this = std::move(merged);
+        rhs.clear();
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::sort()
+    {
+        if(m_itemCount < 2)
+            return;
+        std::vector<T> items;
+        items.reserve(m_itemCount);
+        for(T& item : *this)
+            items.push_back(std::move(item));
+        std::stable_sort(items.begin(), items.end());
+        iterator current = begin();
+        for(T& item : items)
+            *current++ = std::move(item);
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::clear()
+    {
+        Block* current = head;
+        while(current != nullptr)
+        {
+            Block* next = current->m_next;
+            std::destroy_n(current->data(), current->m_count);
+            delete current;
+            current = next;
+        }
+        head = tail = nullptr;
+        m_itemCount = 0;
+    }
+
+    template<typename T, size_t BlockBytes>
+    template<typename F>
+    void UnrolledDll<T, BlockBytes>::forEach(F&& f)
+    {
+        for(Block* current = head; current != nullptr; current = current->m_next)
+        {
+            T* data = current->data();
+            const size_t count = current->m_count;
+            for(size_t i = 0; i < count; ++i)
+                f(data[i]);
+        }
+    }
+
+    template<typename T, size_t BlockBytes>
+    bool UnrolledDll<T, BlockBytes>::isempty() const
+    {
+        return m_itemCount == 0;
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::print() const
+    {
+        for(const T& item : *this)
+        {
+            std::cout << item << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+    template<typename T, size_t BlockBytes>
+    void UnrolledDll<T, BlockBytes>::printFromTail() const
+    {
+        for(Block* current = tail; current != nullptr; current = current->m_prev)
+        {
+            for(size_t i = current->m_count; i-- > 0;)
+                std::cout << current->data()[i] << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+    template<typename T, size_t BlockBytes>
+    size_t UnrolledDll<T, BlockBytes>::size() const
+    {
+        return m_itemCount;
+    }
+
+    template<typename T, size_t BlockBytes>
+    size_t UnrolledDll<T, BlockBytes>::blockCount() const
+    {
+        size_t blocks = 0;
+        for(Block* current = head; current != nullptr; current = current->m_next)
+            ++blocks;
+        return blocks;
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+
+template<typename Weight>
+struct Edge
+{
+    uint32_t from;
+    uint32_t to;
+    Weight weight;
+};
+
+/// Directed weighted graph in compressed sparse row form.
+/// The out-edges of vertex v are targets[offsets[v] .. offsets[v+1]) with the
+/// matching weights, so a relaxation sweep reads two contiguous arrays.
+/// Built once from an edge list with a counting sort; immutable afterwards.
+template<typename Weight = uint32_t>
+class CSRGraph
+{
+    private:
+        std::vector<uint64_t> offsets;                  /// vertexCount + 1 entries
+        std::vector<uint32_t> targets;
+        std::vector<Weight> weights;
+
+    public:
+        static constexpr uint32_t NO_VERTEX = UINT32_MAX;
+
+        CSRGraph() : offsets(1, 0) {}
+        CSRGraph(uint32_t vertices, std::span<const Edge<Weight>> edges);   ////////////////  TC O(V + E)
+
+        CSRGraph(const CSRGraph& src) = default;
+        CSRGraph& operator=(const CSRGraph& rhs) = default;
+        CSRGraph(CSRGraph&& src) noexcept = default;
+        CSRGraph& operator=(CSRGraph&& rhs) noexcept = default;
+        ~CSRGraph() = default;
+
+        uint32_t vertexCount() const;
+        uint64_t edgeCount() const;
+        uint64_t degree(uint32_t v) const;
+        std::span<const uint32_t> neighbors(uint32_t v) const;
+        std::span<const Weight> edgeWeights(uint32_t v) const;   /// parallel to neighbors(v)
+        size_t memoryBytes() const;
+};
+
+template<typename Weight>
+CSRGraph<Weight>::CSRGraph(uint32_t vertices, std::span<const Edge<Weight>> edges)
+                        : offsets(size_t{vertices} + 1, 0),
+                          targets(edges.size()),
+                          weights(edges.size())
+{
+    if(vertices == NO_VERTEX)
+        throw std::length_error("too many vertices");
+    for(const Edge<Weight>& edge : edges)
+    {
+        if(edge.from >= vertices || edge.to >= vertices)
+            throw std::out_of_range("edge endpoint is not a vertex");
+        ++offsets[edge.from + 1];
+    }
+    for(uint32_t v = 0; v < vertices; ++v)
+        offsets[v + 1] += offsets[v];
+
+    std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+    for(const Edge<Weight>& edge : edges)               /// stable, so edges keep their input order per vertex
+    {
+        uint64_t slot = next[edge.from]++;
+        targets[slot] = edge.to;
+        weights[slot] = edge.weight;
+    }
+}
+
+template<typename Weight>
+uint32_t CSRGraph<Weight>::vertexCount() const
+{
+    return static_cast<uint32_t>(offsets.size() - 1);
+}
+
+template<typename Weight>
+uint64_t CSRGraph<Weight>::edgeCount() const
+{
+    return targets.size();
+}
+
+template<typename Weight>
+uint64_t CSRGraph<Weight>::degree(uint32_t v) const
+{
+    return offsets[v + 1] - offsets[v];
+}
+
+template<typename Weight>
+std::span<const uint32_t> CSRGraph<Weight>::neighbors(uint32_t v) const
+{
+    return {targets.data() + offsets[v], static_cast<size_t>(degree(v))};
+}
+
+template<typename Weight>
+std::span<const Weight> CSRGraph<Weight>::edgeWeights(uint32_t v) const
+{
+    return {weights.data() + offsets[v], static_cast<size_t>(degree(v))};
+}
+
+template<typename Weight>
+size_t CSRGraph<Weight>::memoryBytes() const
+{
+    return offsets.size() * sizeof(uint64_t) + targets.size() * sizeof(uint32_t) + weights.size() * sizeof(Weight);
+}
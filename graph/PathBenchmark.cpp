@@ -0,0 +1,138 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "CSRGraph.h"
+#include "ShortestPath.h"
+
+/// Shortest path benchmark: compares the queue policies of ShortestPath on a
+/// generated graph.
+///   PathBenchmark [grid|random] [edges=1000000] [queries=100] [seed=1]
+/// grid   - square 4-neighbour lattice, both directions, weights 1..100; also runs A*
+/// random - edges/8 vertices with uniformly random arcs, weights 1..1000
+
+namespace
+{
+    constexpr uint32_t MAX_WEIGHT_GRID = 100;
+    constexpr uint32_t MAX_WEIGHT_RANDOM = 1000;
+
+    CSRGraph<uint32_t> makeGrid(uint64_t edges, std::mt19937_64& rng, uint32_t& side)
+    {
+        side = std::max<uint32_t>(2, static_cast<uint32_t>(std::sqrt(static_cast<double>(edges) / 4)));
+        const uint32_t vertices = side * side;
+        std::uniform_int_distribution<uint32_t> weight(1, MAX_WEIGHT_GRID);
+        std::vector<Edge<uint32_t>> list;
+        list.reserve(4 * uint64_t{vertices});
+        for(uint32_t y = 0; y < side; ++y)
+        {
+            for(uint32_t x = 0; x < side; ++x)
+            {
+                uint32_t v = y * side + x;
+                if(x + 1 < side)
+                {
+                    uint32_t w = weight(rng);
+                    list.push_back({v, v + 1, w});
+                    list.push_back({v + 1, v, w});
+                }
+                if(y + 1 < side)
+                {
+                    uint32_t w = weight(rng);
+                    list.push_back({v, v + side, w});
+                    list.push_back({v + side, v, w});
+                }
+            }
+        }
+        return CSRGraph<uint32_t>(vertices, list);
+    }
+
+    CSRGraph<uint32_t> makeRandom(uint64_t edges, std::mt19937_64& rng)
+    {
+        const uint32_t vertices = static_cast<uint32_t>(std::max<uint64_t>(2, edges / 8));
+        std::uniform_int_distribution<uint32_t> vertex(0, vertices - 1);
+        std::uniform_int_distribution<uint32_t> weight(1, MAX_WEIGHT_RANDOM);
+        std::vector<Edge<uint32_t>> list;
+        list.reserve(edges);
+        for(uint64_t i = 0; i < edges; ++i)
+            list.push_back({vertex(rng), vertex(rng), weight(rng)});
+        return CSRGraph<uint32_t>(vertices, list);
+    }
+
+    template<typename Queue, typename Heuristic>
+    void run(const char* name, const CSRGraph<uint32_t>& graph, const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+             Heuristic heuristic, bool astar, uint64_t& checksum)
+    {
+        ShortestPath<uint32_t, Queue> engine(graph);
+        uint64_t sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for(auto [source, target] : queries)
+        {
+            uint64_t d = astar ? engine.astar(source, target, [&](uint32_t v) { return heuristic(v, target); })
+                               : engine.dijkstra(source, target);
+            sum += d == engine.INF ? 0 : d;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const OperationCounts& c = engine.counts();
+        const double q = static_cast<double>(c.queries);
+        std::printf("%-10s %-8s %10.2f q/s  push %10.0f  dec %10.0f  pop %10.0f  stale %10.0f  settled %10.0f  relax %11.0f  per query\n",
+                    astar ? "A*" : "Dijkstra", name, q / seconds,
+                    c.pushes / q, c.decreaseKeys / q, c.pops / q, c.stalePops / q, c.settled / q, c.relaxations / q);
+        if(checksum == 0)
+            checksum = sum;
+        else if(checksum != sum)
+            std::printf("  distance checksum mismatch: %llu vs %llu\n", static_cast<unsigned long long>(sum), static_cast<unsigned long long>(checksum));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string kind = argc > 1 ? argv[1] : "grid";
+    const uint64_t edges = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const size_t queryCount = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100;
+    const uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+    if((kind != "grid" && kind != "random") || edges == 0 || queryCount == 0)
+    {
+        std::fprintf(stderr, "usage: %s [grid|random] [edges] [queries] [seed]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(seed);
+    uint32_t side = 0;
+    auto buildStart = std::chrono::steady_clock::now();
+    CSRGraph<uint32_t> graph = kind == "grid" ? makeGrid(edges, rng, side) : makeRandom(edges, rng);
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count();
+    std::printf("%s graph: %u vertices, %llu edges, %.1f MiB CSR, built in %.2f s\n", kind.c_str(), graph.vertexCount(),
+                static_cast<unsigned long long>(graph.edgeCount()), graph.memoryBytes() / 1048576.0, buildSeconds);
+
+    std::uniform_int_distribution<uint32_t> vertex(0, graph.vertexCount() - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> queries(queryCount);
+    for(auto& query : queries)
+        query = {vertex(rng), vertex(rng)};
+
+    /// Manhattan distance times the smallest weight - consistent on the grid
+    auto manhattan = [side](uint32_t v, uint32_t target) -> uint64_t
+    {
+        if(side == 0)
+            return 0;
+        int64_t dx = static_cast<int64_t>(v % side) - static_cast<int64_t>(target % side);
+        int64_t dy = static_cast<int64_t>(v / side) - static_cast<int64_t>(target / side);
+        return static_cast<uint64_t>(std::llabs(dx) + std::llabs(dy));
+    };
+
+    uint64_t checksum = 0;
+    run<LazyHeapQueue>("lazy", graph, queries, manhattan, false, checksum);
+    run<DecreaseKeyQueue>("deckey", graph, queries, manhattan, false, checksum);
+    run<RadixQueue>("radix", graph, queries, manhattan, false, checksum);
+    if(kind == "grid")
+    {
+        run<LazyHeapQueue>("lazy", graph, queries, manhattan, true, checksum);
+        run<DecreaseKeyQueue>("deckey", graph, queries, manhattan, true, checksum);
+        run<RadixQueue>("radix", graph, queries, manhattan, true, checksum);
+    }
+    return 0;
+}
@@ -0,0 +1,259 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "CSRGraph.h"
+#include "../Heap_PriorityQueue/BinaryHeap.h"
+#include "../Heap_PriorityQueue/IndexedHeap.h"
+#include "../Heap_PriorityQueue/RadixHeap.h"
+
+
+/// Heap operations done by the searches since the last resetCounts().
+struct OperationCounts
+{
+    uint64_t queries{0};
+    uint64_t pushes{0};
+    uint64_t decreaseKeys{0};
+    uint64_t pops{0};
+    uint64_t stalePops{0};                              /// lazy deletion: entries popped after a better one
+    uint64_t relaxations{0};                            /// edges scanned
+    uint64_t settled{0};
+};
+
+
+/// Priority queue policies for ShortestPath. Each one keeps (key, vertex) pairs
+/// smallest key first and exposes reset/push/pop/isEmpty; push doubles as
+/// decrease-key when the vertex is already queued.
+
+/// Heap with lazy deletion - a better distance is pushed again and the stale
+/// entry is skipped when it surfaces.
+class LazyHeapQueue
+{
+    private:
+        using Entry = std::pair<uint64_t, uint32_t>;
+        Heap<Entry, 4, std::greater<Entry>> heap;
+
+    public:
+        void reset(uint32_t vertices) { heap.clear(); heap.reserve(vertices / 8 + 16); }
+        void push(uint32_t v, uint64_t key, OperationCounts& counts) { heap.insert(Entry{key, v}); ++counts.pushes; }
+        Entry pop() { return heap.extractMax(); }
+        bool isEmpty() const { return heap.isEmpty(); }
+};
+
+/// IndexedHeap with true decrease-key - every vertex is queued at most once.
+class DecreaseKeyQueue
+{
+    private:
+        using Entry = std::pair<uint64_t, uint32_t>;
+        static constexpr size_t NPOS = SIZE_MAX;
+        IndexedHeap<Entry, 4, std::greater<Entry>> heap;
+        std::vector<size_t> handleOf;                   /// vertex -> handle while queued, NPOS otherwise
+        std::vector<uint32_t> queued;                   /// vertices whose handleOf was set this query
+
+    public:
+        void reset(uint32_t vertices)
+        {
+            if(handleOf.size() != vertices)
+                handleOf.assign(vertices, NPOS);
+            for(uint32_t v : queued)
+                handleOf[v] = NPOS;
+            queued.clear();
+            heap.clear();
+        }
+        void push(uint32_t v, uint64_t key, OperationCounts& counts)
+        {
+            if(handleOf[v] != NPOS)
+            {
+                heap.update(handleOf[v], Entry{key, v});
+                ++counts.decreaseKeys;
+                return;
+            }
+            handleOf[v] = heap.push(Entry{key, v});
+            queued.push_back(v);
+            ++counts.pushes;
+        }
+        Entry pop()
+        {
+            Entry top = heap.extractMax();
+            handleOf[top.second] = NPOS;
+            return top;
+        }
+        bool isEmpty() const { return heap.isEmpty(); }
+};
+
+/// RadixHeap - keys must never drop below the last popped one, which holds for
+/// Dijkstra and for A* with a consistent heuristic. Stale entries as in LazyHeapQueue.
+class RadixQueue
+{
+    private:
+        RadixHeap<uint64_t, uint32_t> heap;
+
+    public:
+        void reset(uint32_t) { heap.clear(); }
+        void push(uint32_t v, uint64_t key, OperationCounts& counts) { heap.insert(key, v); ++counts.pushes; }
+        std::pair<uint64_t, uint32_t> pop() { return heap.extractMin(); }
+        bool isEmpty() const { return heap.isEmpty(); }
+};
+
+
+/// Point-to-point and single-source shortest paths over a CSRGraph with
+/// non-negative integer weights. The per-vertex arrays are allocated once and
+/// invalidated between queries with a generation stamp, so a query costs only
+/// what it touches.
+template<typename Weight = uint32_t, typename Queue = LazyHeapQueue>
+class ShortestPath
+{
+    static_assert(std::is_unsigned_v<Weight>, "ShortestPath needs unsigned integer weights");
+
+    private:
+        const CSRGraph<Weight>& graph;
+        Queue queue;
+        std::vector<uint64_t> dist;
+        std::vector<uint32_t> parent;
+        std::vector<uint32_t> seen;                     /// == query when dist/parent are valid
+        std::vector<uint32_t> done;                     /// == query when settled
+        uint32_t query{0};
+        OperationCounts m_counts;
+
+        void beginQuery();
+        template<typename Heuristic>
+        uint64_t search(uint32_t source, uint32_t target, Heuristic&& heuristic);
+
+    public:
+        static constexpr uint64_t INF = UINT64_MAX;
+        static constexpr uint32_t NO_VERTEX = CSRGraph<Weight>::NO_VERTEX;
+
+        explicit ShortestPath(const CSRGraph<Weight>& graph);
+
+        ShortestPath(const ShortestPath&) = delete;
+        ShortestPath& operator=(const ShortestPath&) = delete;
+        ~ShortestPath() = default;
+
+        uint64_t dijkstra(uint32_t source, uint32_t target = NO_VERTEX);   /// NO_VERTEX target = full SSSP
+        template<typename Heuristic>
+        uint64_t astar(uint32_t source, uint32_t target, Heuristic&& heuristic);   /// heuristic(v) must be consistent
+
+        uint64_t distance(uint32_t v) const;            /// of the last query, INF when not reached
+        std::vector<uint32_t> path(uint32_t target) const;   /// source first, empty when not reached
+        const OperationCounts& counts() const;
+        void resetCounts();
+};
+
+template<typename Weight, typename Queue>
+ShortestPath<Weight, Queue>::ShortestPath(const CSRGraph<Weight>& graph)
+                        : graph{graph},
+                          dist(graph.vertexCount()),
+                          parent(graph.vertexCount()),
+                          seen(graph.vertexCount(), 0),
+                          done(graph.vertexCount(), 0)
+{
+}
+
+template<typename Weight, typename Queue>
+void ShortestPath<Weight, Queue>::beginQuery()
+{
+    if(++query == 0)                                    /// stamps wrapped, old ones could collide
+    {
+        std::fill(seen.begin(), seen.end(), 0);
+        std::fill(done.begin(), done.end(), 0);
+        query = 1;
+    }
+    queue.reset(graph.vertexCount());
+    ++m_counts.queries;
+}
+
+template<typename Weight, typename Queue>
+template<typename Heuristic>
+uint64_t ShortestPath<Weight, Queue>::search(uint32_t source, uint32_t target, Heuristic&& heuristic)
+{
+    beginQuery();
+    if(source >= graph.vertexCount())
+        return INF;
+
+    dist[source] = 0;
+    parent[source] = NO_VERTEX;
+    seen[source] = query;
+    queue.push(source, heuristic(source), m_counts);
+
+    while(!queue.isEmpty())
+    {
+        auto [key, v] = queue.pop();
+        ++m_counts.pops;
+        if(done[v] == query)
+        {
+            ++m_counts.stalePops;
+            continue;
+        }
+        done[v] = query;
+        ++m_counts.settled;
+        if(v == target)
+            return dist[v];
+
+        const uint64_t base = dist[v];
+        std::span<const uint32_t> next = graph.neighbors(v);
+        std::span<const Weight> weight = graph.edgeWeights(v);
+        m_counts.relaxations += next.size();
+        for(size_t i = 0; i < next.size(); ++i)
+        {
+            uint32_t u = next[i];
+            uint64_t candidate = base + weight[i];
+            if(seen[u] == query && candidate >= dist[u])
+                continue;
+            if(done[u] == query)                        /// only an inconsistent heuristic gets here
+                continue;
+            dist[u] = candidate;
+            parent[u] = v;
+            seen[u] = query;
+            queue.push(u, candidate + heuristic(u), m_counts);
+        }
+    }
+    return target == NO_VERTEX ? 0 : INF;
+}
+
+template<typename Weight, typename Queue>
+uint64_t ShortestPath<Weight, Queue>::dijkstra(uint32_t source, uint32_t target)
+{
+    return search(source, target, [](uint32_t) { return uint64_t{0}; });
+}
+
+template<typename Weight, typename Queue>
+template<typename Heuristic>
+uint64_t ShortestPath<Weight, Queue>::astar(uint32_t source, uint32_t target, Heuristic&& heuristic)
+{
+    return search(source, target, std::forward<Heuristic>(heuristic));
+}
+
+template<typename Weight, typename Queue>
+uint64_t ShortestPath<Weight, Queue>::distance(uint32_t v) const
+{
+    return v < seen.size() && seen[v] == query ? dist[v] : INF;
+}
+
+template<typename Weight, typename Queue>
+std::vector<uint32_t> ShortestPath<Weight, Queue>::path(uint32_t target) const
+{
+    std::vector<uint32_t> vertices;
+    if(distance(target) == INF)
+        return vertices;
+    for(uint32_t v = target; v != NO_VERTEX; v = parent[v])
+        vertices.push_back(v);
+    std::reverse(vertices.begin(), vertices.end());
+    return vertices;
+}
+
+template<typename Weight, typename Queue>
+const OperationCounts& ShortestPath<Weight, Queue>::counts() const
+{
+    return m_counts;
+}
+
+template<typename Weight, typename Queue>
+void ShortestPath<Weight, Queue>::resetCounts()
+{
+    m_counts = OperationCounts{};
+}
@@ -0,0 +1,256 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+/// Epoch-based reclamation (Fraser, 2004) for lock-free containers.
+/// Readers wrap each operation in a Guard, which announces the global epoch they
+/// entered in. A node unlinked by a writer is retire()d with the epoch read after
+/// the unlink, and reclaimed once the global epoch is two ahead: the epoch only
+/// advances when every thread inside a Guard has caught up, so by then nobody
+/// who could have seen the node is still inside one.
+/// Cheaper than HazardPointers per read (no per-node publish), but one stalled
+/// thread inside a Guard holds back reclamation for everyone in the domain.
+class EpochDomain
+{
+    private:
+        struct Record;
+
+    public:
+        using Reclaim = void (*)(void*);
+
+        class Guard
+        {
+            public:
+                explicit Guard(EpochDomain& domain);
+                Guard(const Guard&) = delete;
+                Guard& operator=(const Guard&) = delete;
+                ~Guard();
+
+            private:
+                Record* record;
+        };
+
+        EpochDomain();
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+        ~EpochDomain();                                                     /// reclaims everything; no thread may be inside a Guard
+
+        void retire(void* node, Reclaim reclaim);                           /// inside a Guard, after the node is unlinked
+        void collect();                                                     /// tries to advance and reclaims this thread's old nodes
+        uint64_t epoch() const;
+
+        static EpochDomain& global();                                       /// default for containers that do not bring their own
+
+    private:
+        static constexpr uint64_t QUIESCENT = UINT64_MAX;
+        static constexpr size_t ADVANCE_EVERY = 64;                         /// retirements between advance attempts
+
+        struct Retired
+        {
+            void* node;
+            Reclaim reclaim;
+        };
+        struct Bag
+        {
+            uint64_t epoch{0};
+            std::vector<Retired> nodes;
+        };
+        struct alignas(64) Record
+        {
+            std::atomic<uint64_t> epoch{QUIESCENT};                         /// announced epoch while inside a Guard
+            std::atomic<bool> owned{true};
+            Record* next{nullptr};
+            unsigned depth{0};                                              /// Guards nest
+            size_t sinceAdvance{0};
+            Bag bags[3];                                                    /// indexed by epoch % 3
+        };
+        struct State                                                        /// outlives the domain while threads still hold records
+        {
+            alignas(64) std::atomic<uint64_t> epoch{0};
+            std::atomic<Record*> records{nullptr};
+            ~State();
+        };
+        struct Registration
+        {
+            std::shared_ptr<State> state;
+            Record* record;
+        };
+        struct Registry                                                     /// per thread
+        {
+            std::vector<Registration> entries;
+            ~Registry();
+        };
+
+        std::shared_ptr<State> state;
+
+        Record& local();
+        static Record* acquire(State& state);
+        bool tryAdvance();
+        static void reclaim(Bag& bag);
+        void reclaimOld(Record& record);
+
+        friend class Guard;
+};
+
+inline EpochDomain::EpochDomain() : state{std::make_shared<State>()}
+{}
+
+inline EpochDomain::~EpochDomain()
+{
+    for(Record* record = state->records.load(std::memory_order_acquire); record != nullptr; record = record->next)
+    {
+        for(Bag& bag : record->bags)
+            reclaim(bag);
+    }
+}
+
+inline EpochDomain::State::~State()
+{
+    Record* record = records.load(std::memory_order_relaxed);
+    while(record != nullptr)
+    {
+        Record* next = record->next;
+        for(Bag& bag : record->bags)
+            reclaim(bag);
+        delete record;
+        record = next;
+    }
+}
+
+inline EpochDomain::Registry::~Registry()
+{
+    for(Registration& entry : entries)
+    {
+        entry.record->epoch.store(QUIESCENT, std::memory_order_release);
+        entry.record->owned.store(false, std::memory_order_release);        ///its bags wait for the next owner
+    }
+}
+
+inline EpochDomain& EpochDomain::global()
+{
+    static EpochDomain* instance = new EpochDomain;                         ///never destroyed: threads may outlive static teardown
+    return *instance;
+}
+
+inline EpochDomain::Record* EpochDomain::acquire(State& state)
+{
+    for(Record* current = state.records.load(std::memory_order_acquire); current != nullptr; current = current->next)
+    {
+        bool idle = false;
+        if(!current->owned.load(std::memory_order_relaxed) &&
+           current->owned.compare_exchange_strong(idle, true, std::memory_order_acquire))
+            return current;
+    }
+    Record* record = new Record;
+    Record* first = state.records.load(std::memory_order_relaxed);
+    do
+    {
+        record->next = first;
+    } while(!state.records.compare_exchange_weak(first, record, std::memory_order_release, std::memory_order_relaxed));
+    return record;
+}
+
+inline EpochDomain::Record& EpochDomain::local()
+{
+    thread_local Registry registry;
+    std::vector<Registration>& entries = registry.entries;
+    for(Registration& entry : entries)
+    {
+        if(entry.state == state)
+            return *entry.record;
+    }
+
+    for(size_t i = 0; i < entries.size();)                                  ///drop domains that are gone
+    {
+        if(entries[i].state.use_count() == 1)
+        {
+            entries[i].record->owned.store(false, std::memory_order_release);
+            entries[i] = std::move(entries.back());
+            entries.pop_back();
+        }
+        else
+            ++i;
+    }
+    entries.push_back(Registration{state, acquire(*state)});
+    return *entries.back().record;
+}
+
+inline EpochDomain::Guard::Guard(EpochDomain& domain) : record{&domain.local()}
+{
+    if(record->depth++ == 0)
+    {
+        record->epoch.store(domain.state->epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);                ///announce before the first read
+    }
+}
+
+inline EpochDomain::Guard::~Guard()
+{
+    if(--record->depth == 0)
+        record->epoch.store(QUIESCENT, std::memory_order_release);
+}
+
+inline void EpochDomain::retire(void* node, Reclaim reclaim)
+{
+    Record& record = local();
+    uint64_t current = state->epoch.load(std::memory_order_seq_cst);        ///read after the unlink
+    Bag& bag = record.bags[current % 3];
+    if(bag.epoch != current)                                                ///three epochs old, so safe
+    {
+        EpochDomain::reclaim(bag);
+        bag.epoch = current;
+    }
+    bag.nodes.push_back(Retired{node, reclaim});
+
+    if(++record.sinceAdvance >= ADVANCE_EVERY)
+    {
+        record.sinceAdvance = 0;
+        tryAdvance();
+        reclaimOld(record);
+    }
+}
+
+inline void EpochDomain::collect()
+{
+    tryAdvance();
+    reclaimOld(local());
+}
+
+inline uint64_t EpochDomain::epoch() const
+{
+    return state->epoch.load(std::memory_order_acquire);
+}
+
+inline bool EpochDomain::tryAdvance()
+{
+    uint64_t current = state->epoch.load(std::memory_order_seq_cst);
+    for(Record* record = state->records.load(std::memory_order_acquire); record != nullptr; record = record->next)
+    {
+        uint64_t announced = record->epoch.load(std::memory_order_seq_cst);
+        if(announced != QUIESCENT && announced != current)
+            return false;
+    }
+    return state->epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+}
+
+inline void EpochDomain::reclaim(Bag& bag)
+{
+    for(Retired& retired : bag.nodes)
+        retired.reclaim(retired.node);
+    bag.nodes.clear();                                                      ///keeps the capacity
+}
+
+inline void EpochDomain::reclaimOld(Record& record)
+{
+    uint64_t current = state->epoch.load(std::memory_order_seq_cst);
+    for(Bag& bag : record.bags)
+    {
+        if(!bag.nodes.empty() && bag.epoch + 2 <= current)
+            reclaim(bag);
+    }
+}
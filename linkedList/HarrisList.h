@@ -0,0 +1,193 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "EpochReclamation.h"
+
+
+/// Lock-free ordered set on a singly linked list (Harris, 2001; Michael's
+/// variant, which unlinks one marked node at a time).
+/// The low bit of a node's next pointer marks the node itself as deleted. remove
+/// sets the mark first - the logical delete, which also blocks inserts after the
+/// node - and then swings the predecessor past it. Any traversal that meets a
+/// marked node finishes the unlink. Unlinked nodes go to an EpochDomain, so contains()
+/// walks the list without writing anything shared.
+template<typename T, typename Compare = std::less<T>>
+class HarrisList
+{
+    private:
+        struct Node
+        {
+            T key;
+            std::atomic<uintptr_t> next{0};                         /// Node* | deleted bit
+
+            explicit Node(T key) : key{std::move(key)} {}
+        };
+        struct Position
+        {
+            std::atomic<uintptr_t>* prev;                           /// link that points at curr
+            Node* curr;                                             /// first node not less than the key
+        };
+
+        static constexpr uintptr_t MARK = 1;
+        static bool isMarked(uintptr_t link) { return (link & MARK) != 0; }
+        static Node* pointer(uintptr_t link) { return reinterpret_cast<Node*>(link & ~MARK); }
+        static uintptr_t address(Node* node) { return reinterpret_cast<uintptr_t>(node); }
+
+        std::atomic<uintptr_t> head{0};
+        EpochDomain& domain;
+        Compare comp;
+
+        Position find(const T& key);                                /// unlinks marked nodes on the way
+        bool equal(const Node* node, const T& key) const { return node != nullptr && !comp(key, node->key); }
+        static void destroy(void* node);
+
+    public:
+        explicit HarrisList(EpochDomain& domain = EpochDomain::global(), const Compare& compare = Compare{});
+        HarrisList(const HarrisList&) = delete;
+        HarrisList& operator=(const HarrisList&) = delete;
+        ~HarrisList();                                              /// no other thread may still be using the list
+
+        bool insert(T key);                                         ////////////////  TC n, lock-free, false if present
+        bool remove(const T& key);                                  ////////////////  TC n, lock-free, false if absent
+        bool contains(const T& key);                                ////////////////  TC n, wait-free apart from the Guard
+        size_t size();                                              /// racy snapshot
+        bool isEmpty();                                             /// racy snapshot, stops at the first live node
+};
+
+template<typename T, typename Compare>
+HarrisList<T, Compare>::HarrisList(EpochDomain& domain, const Compare& compare) : domain{domain}, comp{compare}
+{}
+
+template<typename T, typename Compare>
+HarrisList<T, Compare>::~HarrisList()
+{
+    Node* current = pointer(head.load(std::memory_order_relaxed));
+    while(current != nullptr)                                       ///marked nodes still linked are ours too
+    {
+        Node* next = pointer(current->next.load(std::memory_order_relaxed));
+        delete current;
+        current = next;
+    }
+}
+
+template<typename T, typename Compare>
+void HarrisList<T, Compare>::destroy(void* node)
+{
+    delete static_cast<Node*>(node);
+}
+
+template<typename T, typename Compare>
+typename HarrisList<T, Compare>::Position HarrisList<T, Compare>::find(const T& key)
+{
+retry:
+    std::atomic<uintptr_t>* prev = &head;
+    uintptr_t link = prev->load(std::memory_order_acquire);
+    while(true)
+    {
+        Node* curr = pointer(link);
+        if(curr == nullptr)
+            return Position{prev, nullptr};
+        uintptr_t next = curr->next.load(std::memory_order_acquire);
+        if(isMarked(next))                                          ///curr is deleted - unlink it before going on
+        {
+            uintptr_t expected = address(curr);
+            if(!prev->compare_exchange_strong(expected, next & ~MARK, std::memory_order_acq_rel, std::memory_order_acquire))
+                goto retry;                                         ///prev changed or was itself deleted
+            domain.retire(curr, &destroy);
+            link = next & ~MARK;
+            continue;
+        }
+        if(!comp(curr->key, key))
+            return Position{prev, curr};
+        prev = &curr->next;
+        link = next;
+    }
+}
+
+template<typename T, typename Compare>
+bool HarrisList<T, Compare>::insert(T key)
+{
+    EpochDomain::Guard guard{domain};
+    Node* node = nullptr;
+    while(true)
+    {
+        Position position = find(node != nullptr ? node->key : key);
+        if(equal(position.curr, node != nullptr ? node->key : key))
+        {
+            delete node;
+            return false;
+        }
+        if(node == nullptr)
+            node = new Node{std::move(key)};
+        node->next.store(address(position.curr), std::memory_order_relaxed);
+        uintptr_t expected = address(position.curr);
+        if(position.prev->compare_exchange_strong(expected, address(node), std::memory_order_release, std::memory_order_relaxed))
+            return true;
+    }
+}
+
+template<typename T, typename Compare>
+bool HarrisList<T, Compare>::remove(const T& key)
+{
+    EpochDomain::Guard guard{domain};
+    while(true)
+    {
+        Position position = find(key);
+        if(!equal(position.curr, key))
+            return false;
+        Node* curr = position.curr;
+        uintptr_t next = curr->next.load(std::memory_order_acquire);
+        if(isMarked(next))                                          ///lost to another remove; find cleans up
+            continue;
+        if(!curr->next.compare_exchange_weak(next, next | MARK, std::memory_order_acq_rel, std::memory_order_relaxed))
+            continue;
+
+        uintptr_t expected = address(curr);                         ///logically gone; now try to unlink it
+        if(position.prev->compare_exchange_strong(expected, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+            domain.retire(curr, &destroy);
+        else
+            find(key);
+        return true;
+    }
+}
+
+template<typename T, typename Compare>
+bool HarrisList<T, Compare>::contains(const T& key)
+{
+    EpochDomain::Guard guard{domain};
+    Node* curr = pointer(head.load(std::memory_order_acquire));
+    while(curr != nullptr && comp(curr->key, key))
+        curr = pointer(curr->next.load(std::memory_order_acquire));
+    return equal(curr, key) && !isMarked(curr->next.load(std::memory_order_acquire));
+}
+
+template<typename T, typename Compare>
+size_t HarrisList<T, Compare>::size()
+{
+    EpochDomain::Guard guard{domain};
+    size_t count = 0;
+    for(Node* curr = pointer(head.load(std::memory_order_acquire)); curr != nullptr;)
+    {
+        uintptr_t next = curr->next.load(std::memory_order_acquire);
+        count += !isMarked(next);
+        curr = pointer(next);
+    }
+    return count;
+}
+
+template<typename T, typename Compare>
+bool HarrisList<T, Compare>::isEmpty()
+{
+    EpochDomain::Guard guard{domain};
+    for(Node* curr = pointer(head.load(std::memory_order_acquire)); curr != nullptr;)
+    {
+        uintptr_t next = curr->next.load(std::memory_order_acquire);
+        if(!isMarked(next))
+            return false;
+        curr = pointer(next);
+    }
+    return true;
+}
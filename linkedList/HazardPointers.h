@@ -0,0 +1,154 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+/// Hazard pointers (Michael, 2004) for the lock-free lists in this folder.
+/// Every thread owns a record with SLOTS published pointers. A node that has been
+/// unlinked is retire()d, and its reclaim function runs once no slot anywhere
+/// holds it. Records are never freed: at thread exit a record is released with
+/// its retired nodes still attached, and the next thread to take it scans them.
+class HazardPointers
+{
+    public:
+        static constexpr size_t SLOTS = 2;
+        using Reclaim = void (*)(void*);
+
+        template<typename Node>
+        static Node* protect(size_t index, const std::atomic<Node*>& source);  /// publishes, then re-reads until stable
+        static void publish(size_t index, const void* node);                  /// caller re-validates
+        static void clear();                                                   /// drops this thread's slots
+        static void retire(void* node, Reclaim reclaim);                       /// amortised O(threads * SLOTS)
+        static void collect();                                                 /// scans this thread's retired nodes now
+
+    private:
+        struct Retired
+        {
+            void* node;
+            Reclaim reclaim;
+        };
+        struct alignas(64) Record
+        {
+            std::atomic<const void*> slots[SLOTS]{};
+            std::atomic<bool> active{true};
+            Record* next{nullptr};
+            std::vector<Retired> retired;
+            std::vector<const void*> scratch;                               /// kept so a scan does not allocate
+        };
+        struct Owner
+        {
+            Record* record;
+            Owner();
+            ~Owner();
+        };
+
+        inline static std::atomic<Record*> records{nullptr};
+        inline static std::atomic<size_t> recordCount{0};
+
+        static Record& local();
+        static void scan(Record& record);
+};
+
+inline HazardPointers::Owner::Owner()
+{
+    for(Record* current = records.load(std::memory_order_acquire); current != nullptr; current = current->next)
+    {
+        bool idle = false;
+        if(!current->active.load(std::memory_order_relaxed) &&
+           current->active.compare_exchange_strong(idle, true, std::memory_order_acquire))
+        {
+            record = current;
+            return;
+        }
+    }
+    record = new Record;                                                    ///reachable from records forever
+    Record* first = records.load(std::memory_order_relaxed);
+    do
+    {
+        record->next = first;
+    } while(!records.compare_exchange_weak(first, record, std::memory_order_release, std::memory_order_relaxed));
+    recordCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline HazardPointers::Owner::~Owner()
+{
+    for(std::atomic<const void*>& slot : record->slots)
+        slot.store(nullptr, std::memory_order_release);
+    record->active.store(false, std::memory_order_release);
+}
+
+inline HazardPointers::Record& HazardPointers::local()
+{
+    thread_local Owner owner;
+    return *owner.record;
+}
+
+template<typename Node>
+Node* HazardPointers::protect(size_t index, const std::atomic<Node*>& source)
+{
+    std::atomic<const void*>& slot = local().slots[index];
+    Node* node = source.load(std::memory_order_relaxed);
+    while(true)
+    {
+        slot.store(node, std::memory_order_seq_cst);                        ///must be visible before the re-read
+        Node* again = source.load(std::memory_order_seq_cst);
+        if(again == node)
+            return node;
+        node = again;
+    }
+}
+
+inline void HazardPointers::publish(size_t index, const void* node)
+{
+    local().slots[index].store(node, std::memory_order_seq_cst);
+}
+
+inline void HazardPointers::clear()
+{
+    for(std::atomic<const void*>& slot : local().slots)
+        slot.store(nullptr, std::memory_order_release);
+}
+
+inline void HazardPointers::retire(void* node, Reclaim reclaim)
+{
+    Record& record = local();
+    record.retired.push_back(Retired{node, reclaim});
+    /// max(64, 2 * SLOTS * records): at most SLOTS * records nodes can be protected, so a scan
+    /// frees at least half the list; the floor of 64 batches scans when only a few threads run
+    size_t threshold = std::max<size_t>(64, 2 * SLOTS * recordCount.load(std::memory_order_relaxed));
+    if(record.retired.size() >= threshold)
+        scan(record);
+}
+
+inline void HazardPointers::collect()
+{
+    scan(local());
+}
+
+inline void HazardPointers::scan(Record& record)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::vector<const void*>& hazards = record.scratch;
+    hazards.clear();
+    for(Record* current = records.load(std::memory_order_acquire); current != nullptr; current = current->next)
+    {
+        for(const std::atomic<const void*>& slot : current->slots)
+        {
+            if(const void* node = slot.load(std::memory_order_seq_cst))
+                hazards.push_back(node);
+        }
+    }
+    std::sort(hazards.begin(), hazards.end());
+
+    size_t kept = 0;
+    for(Retired& retired : record.retired)
+    {
+        if(std::binary_search(hazards.begin(), hazards.end(), static_cast<const void*>(retired.node)))
+            record.retired[kept++] = retired;
+        else
+            retired.reclaim(retired.node);
+    }
+    record.retired.resize(kept);
+}
@@ -1,6 +1,10 @@
 #include <iostream>
 #include <initializer_list>
+#include <cstdint>
 #include <list>
+#include <new>
+#include <stdexcept>
+#include <utility>
 
 
 template<typename T>
@@ -12,41 +16,75 @@ class List
             public:
                 T data;
                 Node* next{nullptr};
-                Node(T data = T(), Node* next = nullptr)   ///ctor
-                {
-                    this->data = data;
-                    this->next = next;
-                }
+                template<typename... Args>
+                explicit Node(Node* next, Args&&... args) : data(std::forward<Args>(args)...), next{next} {}   ///built in place, no copy
         };
+        struct FreeSlot                                         /// a recycled node's memory, T already destroyed
+        {
+            FreeSlot* next;
+        };
+
+        static constexpr uint32_t DEFAULT_RECYCLE_LIMIT = 1024;
 
         uint32_t size{0};
         Node* head{nullptr};
+        Node* tail{nullptr};                                    /// O(1) push_back
+        FreeSlot* recycled{nullptr};
+        uint32_t recycledCount{0};
+        uint32_t recycleLimit{DEFAULT_RECYCLE_LIMIT};
 
-        void inRange(const uint32_t& index)
+        void inRange(const uint32_t& index) const               /// for access and remove
         {
-            if(index > size || index < 0)
+            if(index >= size)
                 throw std::out_of_range { "index is out of range"};
         }
-        Node* find(const uint32_t& index);
+        void inInsertRange(const uint32_t& index) const         /// index == size appends
+        {
+            if(index > size)
+                throw std::out_of_range { "index is out of range"};
+        }
+        Node* find(const uint32_t& index) const;
+        template<typename... Args>
+        Node* createNode(Node* next, Args&&... args);           /// reuses recycled memory first
+        void destroyNode(Node* node);                           /// keeps the memory while under recycleLimit
+        void releaseRecycled(uint32_t keep);
+        template<typename... Args>
+        T& emplaceAt(const uint32_t& index, Args&&... args);
 
     public:
         List();                                                 /// default ctor with default parameters
+        explicit List(uint32_t recycleLimit);                   /// nodes kept for reuse after pop/remove/clear
         List(const List<T>& src);                               /// copy ctor
+        List<T>& operator=(const List<T>& rhs);
+        List(List<T>&& src) noexcept;
+        List<T>& operator=(List<T>&& rhs) noexcept;
         explicit List(const std::initializer_list<T>& init);    /// ctor initializer-List
         ~List();                                                /// dtor
 
         T& operator[](const uint32_t& index);                   ///subscript operator
         const Node* getHead() const;
 
-        void push_back(const T& data);
+        void push_back(const T& data);                          ////////////////  TC 1
+        void push_back(T&& data);
+        template<typename... Args>
+        T& emplace_back(Args&&... args);
         void push_front(const T& data);
-        
-        void pop_back();
+        void push_front(T&& data);
+        template<typename... Args>
+        T& emplace_front(Args&&... args);
+
+        void pop_back();                                        ////////////////  TC n, singly linked
         void pop_front();
 
         void insert(const T& data,const uint32_t& index);
+        void insert(T&& data,const uint32_t& index);
+        template<typename... Args>
+        T& emplace(const uint32_t& index, Args&&... args);
         void remove(const uint32_t& index);
-        void clear();
+        void clear();                                           /// nodes go to the free list up to recycleLimit
+
+        void setRecycleLimit(uint32_t limit);                   /// frees recycled nodes above the new limit
+        const uint32_t& recycledNodes() const;
 
         void printList();
         const uint32_t& Size() const;
@@ -60,30 +98,134 @@ List<T>::List()
     head = nullptr;
 }
 
+template<typename T>
+List<T>::List(uint32_t recycleLimit) : recycleLimit{recycleLimit}
+{}
+
 template<typename T>
 List<T>::List(const std::initializer_list<T>&  init)
 {
-    Node* head = new Node{};
-    Node* curr = head;
-    size = init.size();
-    
-    typename std::initializer_list<T>::iterator iter = init.begin();
-    while(iter != init.end()-1)
+    try
+    {
+        for(const T& item : init)
+            push_back(item);
+    }
+    catch(...)
     {
-        curr->data = *iter;
-        curr->next = new Node{};
-        curr = curr->next;
-        ++iter;
+        clear();
+        releaseRecycled(0);
+        throw;
     }
-    curr->data = *iter;
-    this->head = head;
+}
+
+template<typename T>
+List<T>::List(const List<T>& src) : recycleLimit{src.recycleLimit}
+{
+    try
+    {
+        for(const Node* current = src.head; current != nullptr; current = current->next)
+            push_back(current->data);
+    }
+    catch(...)
+    {
+        clear();
+        releaseRecycled(0);
+        throw;
+    }
+}
+
+template<typename T>
+List<T>& List<T>::operator=(const List<T>& rhs)
+{
+    if(this == &rhs)
+        return *this;
+    List<T> tmp{rhs};                                           ///tmp leaves with our old nodes
+    std::swap(size, tmp.size);
+    std::swap(head, tmp.head);
+    std::swap(tail, tmp.tail);
+    return *this;
+}
+
+template<typename T>
+List<T>::List(List<T>&& src) noexcept
+                : size{std::exchange(src.size, 0U)},
+                  head{std::exchange(src.head, nullptr)},
+                  tail{std::exchange(src.tail, nullptr)},
+                  recycleLimit{src.recycleLimit}
+{}
+
+template<typename T>
+List<T>& List<T>::operator=(List<T>&& rhs) noexcept
+{
+    if(this == &rhs)
+        return *this;
+    clear();
+    size = std::exchange(rhs.size, 0U);
+    head = std::exchange(rhs.head, nullptr);
+    tail = std::exchange(rhs.tail, nullptr);
+    return *this;
 }
 
 template<typename T>
 List<T>::~List()
 {
     clear();
+    releaseRecycled(0);
+}
+
+template<typename T>
+template<typename... Args>
+typename List<T>::Node* List<T>::createNode(Node* next, Args&&... args)
+{
+    void* memory = nullptr;
+    if(recycled != nullptr)
+    {
+        memory = recycled;
+        recycled = recycled->next;
+        --recycledCount;
+    }
+    else
+    {
+        memory = ::operator new(sizeof(Node));
+    }
+    try
+    {
+        return new (memory) Node(next, std::forward<Args>(args)...);
+    }
+    catch(...)
+    {
+        ::operator delete(memory);
+        throw;
+    }
 }
+
+template<typename T>
+void List<T>::destroyNode(Node* node)
+{
+    node->~Node();
+    if(recycledCount < recycleLimit)
+    {
+        recycled = new (static_cast<void*>(node)) FreeSlot{recycled};
+        ++recycledCount;
+    }
+    else
+    {
+        ::operator delete(static_cast<void*>(node));
+    }
+}
+
+template<typename T>
+void List<T>::releaseRecycled(uint32_t keep)
+{
+    while(recycledCount > keep)
+    {
+        FreeSlot* slot = recycled;
+        recycled = slot->next;
+        ::operator delete(static_cast<void*>(slot));
+        --recycledCount;
+    }
+}
+
 template<typename T>
 const typename List<T>::Node* List<T>::getHead() const
 {
@@ -93,51 +235,114 @@ const typename List<T>::Node* List<T>::getHead() const
 template<typename T>
 T& List<T>::operator[](const uint32_t& index)
 {
-    inRange(index);
     return find(index)->data;
-    throw std::runtime_error("No valid return value found.");
 }
 
 template<typename T>
-typename List<T>::Node* List<T>::find(const uint32_t& index)
+typename List<T>::Node* List<T>::find(const uint32_t& index) const
 {
     inRange(index);
-    uint32_t count = 0U;
+    if(index == size - 1)
+        return tail;
     Node* current = this->head;
-    while(current != nullptr)
+    for(uint32_t count = 0U; count != index; ++count)
     {
-        if(count == index)
-            return current;
         current = current->next;
-        ++count;
     }
-    throw std::runtime_error("No valid return value found.");
+    return current;
+}
+
+template<typename T>
+template<typename... Args>
+T& List<T>::emplaceAt(const uint32_t& index, Args&&... args)
+{
+    if(index == 0)
+    {
+        this->head = createNode(this->head, std::forward<Args>(args)...);
+        if(tail == nullptr)
+            tail = head;
+        ++size;
+        return head->data;
+    }
+    Node* prev = find(index-1);
+    Node* newNode = createNode(prev->next, std::forward<Args>(args)...);
+    prev->next = newNode;
+    if(prev == tail)
+        tail = newNode;
+    ++size;
+    return newNode->data;
 }
 
 template<typename T>
 void List<T>::push_back(const T& data)
 {
+    emplace_back(data);
+}
+
+template<typename T>
+void List<T>::push_back(T&& data)
+{
+    emplace_back(std::move(data));
+}
+
+template<typename T>
+template<typename... Args>
+T& List<T>::emplace_back(Args&&... args)
+{
+    Node* newNode = createNode(nullptr, std::forward<Args>(args)...);
     if(this->head == nullptr)
     {
-        this->head = new Node{data};
+        this->head = newNode;
     }
     else
     {
-        Node* current = this->head;
-        while(current->next != nullptr)
-        {
-            current = current->next;
-        }
-        current->next = new Node{data};
+        tail->next = newNode;
     }
-    ++size;  
+    tail = newNode;
+    ++size;
+    return newNode->data;
 }
 
 template<typename T>
 void List<T>::push_front(const T& data)
 {
-    this->head = new Node(data,this->head);
-    ++size;
+    emplace_front(data);
+}
+
+template<typename T>
+void List<T>::push_front(T&& data)
+{
+    emplace_front(std::move(data));
+}
+
+template<typename T>
+template<typename... Args>
+T& List<T>::emplace_front(Args&&... args)
+{
+    return emplaceAt(0U, std::forward<Args>(args)...);
+}
+
+template<typename T>
+void List<T>::pop_back()
+{
+    if(head == nullptr)
+    {
+        throw std::range_error("list is empty");
+    }
+    if(head == tail)
+    {
+        destroyNode(head);
+        head = nullptr;
+        tail = nullptr;
+    }
+    else
+    {
+        Node* prev = find(size-2);
+        destroyNode(tail);
+        prev->next = nullptr;
+        tail = prev;
+    }
+    --size;
 }
 
 template<typename T>
@@ -147,62 +352,61 @@ void List<T>::pop_front()
     {
         Node* current = this->head;
         this->head = head->next;
-        current->next = nullptr;
-        delete current;
-        current = nullptr;
-        --size;  
+        if(this->head == nullptr)
+            tail = nullptr;
+        destroyNode(current);
+        --size;
     }
     else
     {
         throw std::range_error("list is empty");
-    } 
+    }
 }
 
 template<typename T>
 void List<T>::insert(const T& data,const uint32_t& index)
 {
-    inRange(index);
-    Node* newNode = new Node{data};
-    if(newNode == nullptr)
-    {
-        throw std::bad_alloc{};
-    }
-    else
-    {
-        if(index == 0)
-        {
-            newNode->next = this->head;
-            this->head = newNode;
-            ++size;
-        }
-        else
-        {
-            Node* prev = find(index-1);
-            newNode->next = prev->next;
-            prev->next = newNode;
-        }
-    }
+    inInsertRange(index);
+    emplaceAt(index, data);
+}
 
+template<typename T>
+void List<T>::insert(T&& data,const uint32_t& index)
+{
+    inInsertRange(index);
+    emplaceAt(index, std::move(data));
 }
+
+template<typename T>
+template<typename... Args>
+T& List<T>::emplace(const uint32_t& index, Args&&... args)
+{
+    inInsertRange(index);
+    return emplaceAt(index, std::forward<Args>(args)...);
+}
+
 template<typename T>
 void List<T>::remove(const uint32_t& index)
 {
-    inRange();
+    inRange(index);
     Node* current {nullptr};
     if(index == 0)
     {
         current = this->head;
         this->head = current->next;
+        if(this->head == nullptr)
+            tail = nullptr;
     }
     else
     {
         Node* prev = find(index-1);
         current = prev->next;
         prev->next = current->next;
+        if(current == tail)
+            tail = prev;
     }
-    current->next = nullptr;
-    delete current;
-    current = nullptr;
+    destroyNode(current);
+    --size;
 }
 
 template<typename T>
@@ -214,6 +418,19 @@ void List<T>::clear()
     }
 }
 
+template<typename T>
+void List<T>::setRecycleLimit(uint32_t limit)
+{
+    recycleLimit = limit;
+    releaseRecycled(limit);
+}
+
+template<typename T>
+const uint32_t& List<T>::recycledNodes() const
+{
+    return recycledCount;
+}
+
 template<typename T>
 void List<T>::printList()
 {
@@ -222,16 +439,15 @@ void List<T>::printList()
         Node* curr = this->head;
         while(curr != nullptr)
         {
-            std::cout << curr->data << std::endl; 
-            curr = curr->next;       
+            std::cout << curr->data << std::endl;
+            curr = curr->next;
         }
     }
     else
     {
         throw std::range_error("list is empty");
     }
-}   
+}
 
 template<typename T>
 const uint32_t& List<T>::Size() const {return size;}
-
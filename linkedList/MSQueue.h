@@ -0,0 +1,278 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "HazardPointers.h"
+
+
+/// Lock-free multi-producer/multi-consumer FIFO (Michael & Scott, 1996).
+/// Singly linked like List, but head and tail are atomic and head always points
+/// at a dummy node: dequeue moves the value out of head->next, which then becomes
+/// the dummy. Unlinked nodes are retired through HazardPointers and recycled
+/// through per-thread caches backed by a mutex-guarded stack of node batches, so
+/// steady-state traffic never reaches malloc.
+template<typename T>
+class MSQueue
+{
+    static_assert(std::is_nothrow_move_constructible_v<T>, "dequeue moves the value out after it has already been unlinked");
+
+    private:
+        struct Node
+        {
+            std::atomic<Node*> next{nullptr};
+            alignas(T) unsigned char storage[sizeof(T)];            /// holds a value only behind the dummy
+
+            T& data() { return *std::launder(reinterpret_cast<T*>(storage)); }
+        };
+
+        class NodeCache
+        {
+            private:
+                static constexpr size_t BATCH = 64;
+                static constexpr size_t MAX_SHARED_BATCHES = 1024;  /// beyond that, surplus nodes are freed
+
+                struct Chain
+                {
+                    Node* first;
+                    size_t count;
+                };
+                struct Shared
+                {
+                    std::mutex lock;
+                    std::vector<Chain> batches;
+                };
+                struct Local
+                {
+                    Node* first{nullptr};
+                    size_t count{0};
+                    ~Local();                                       /// hands everything to the shared stack
+                };
+
+                static Shared& shared();
+                static Local& local();
+                static void give(Chain chain);
+
+            public:
+                static Node* acquire();
+                static void release(Node* node);
+        };
+
+        alignas(64) std::atomic<Node*> head;                        /// dequeuers and enqueuers on separate lines
+        alignas(64) std::atomic<Node*> tail;
+
+        static void recycle(void* node);
+
+    public:
+        MSQueue();
+        MSQueue(const MSQueue&) = delete;
+        MSQueue& operator=(const MSQueue&) = delete;
+        ~MSQueue();                                                 /// no other thread may still be using the queue
+
+        template<typename U>
+        void enqueue(U&& value);                                    ////////////////  TC 1, lock-free
+        std::optional<T> dequeue();                                 ////////////////  TC 1, lock-free, nullopt when empty
+        bool isEmpty() const;                                       /// racy snapshot
+};
+
+template<typename T>
+typename MSQueue<T>::NodeCache::Shared& MSQueue<T>::NodeCache::shared()
+{
+    static Shared* instance = new Shared;                           ///never destroyed: exiting threads still flush into it
+    return *instance;
+}
+
+template<typename T>
+typename MSQueue<T>::NodeCache::Local& MSQueue<T>::NodeCache::local()
+{
+    thread_local Local cache;
+    return cache;
+}
+
+template<typename T>
+MSQueue<T>::NodeCache::Local::~Local()
+{
+    while(first != nullptr)
+    {
+        Chain chain{first, 0};
+        Node* last = first;
+        for(chain.count = 1; chain.count < BATCH && last->next.load(std::memory_order_relaxed) != nullptr; ++chain.count)
+            last = last->next.load(std::memory_order_relaxed);
+        first = last->next.load(std::memory_order_relaxed);
+        last->next.store(nullptr, std::memory_order_relaxed);
+        give(chain);
+    }
+    count = 0;
+}
+
+template<typename T>
+void MSQueue<T>::NodeCache::give(Chain chain)
+{
+    {
+        Shared& stack = shared();
+        std::lock_guard<std::mutex> guard{stack.lock};
+        if(stack.batches.size() < MAX_SHARED_BATCHES)
+        {
+            stack.batches.push_back(chain);
+            return;
+        }
+    }
+    while(chain.first != nullptr)
+    {
+        Node* next = chain.first->next.load(std::memory_order_relaxed);
+        delete chain.first;
+        chain.first = next;
+    }
+}
+
+template<typename T>
+typename MSQueue<T>::Node* MSQueue<T>::NodeCache::acquire()
+{
+    Local& cache = local();
+    if(cache.first == nullptr)
+    {
+        Shared& stack = shared();
+        std::lock_guard<std::mutex> guard{stack.lock};
+        if(!stack.batches.empty())
+        {
+            cache.first = stack.batches.back().first;
+            cache.count = stack.batches.back().count;
+            stack.batches.pop_back();
+        }
+    }
+    if(cache.first == nullptr)
+        return new Node;
+
+    Node* node = cache.first;
+    cache.first = node->next.load(std::memory_order_relaxed);
+    --cache.count;
+    node->next.store(nullptr, std::memory_order_relaxed);
+    return node;
+}
+
+template<typename T>
+void MSQueue<T>::NodeCache::release(Node* node)
+{
+    Local& cache = local();
+    node->next.store(cache.first, std::memory_order_relaxed);
+    cache.first = node;
+    if(++cache.count < 2 * BATCH)
+        return;
+
+    Node* last = cache.first;                                       ///keep one batch, pass the other on
+    for(size_t i = 1; i < BATCH; ++i)
+        last = last->next.load(std::memory_order_relaxed);
+    Chain chain{last->next.load(std::memory_order_relaxed), cache.count - BATCH};
+    last->next.store(nullptr, std::memory_order_relaxed);
+    cache.count = BATCH;
+    give(chain);
+}
+
+template<typename T>
+void MSQueue<T>::recycle(void* node)
+{
+    NodeCache::release(static_cast<Node*>(node));
+}
+
+template<typename T>
+MSQueue<T>::MSQueue()
+{
+    Node* dummy = NodeCache::acquire();
+    head.store(dummy, std::memory_order_relaxed);
+    tail.store(dummy, std::memory_order_relaxed);
+}
+
+template<typename T>
+MSQueue<T>::~MSQueue()
+{
+    Node* current = head.load(std::memory_order_relaxed);
+    Node* next = current->next.load(std::memory_order_relaxed);
+    NodeCache::release(current);                                    ///the dummy holds no value
+    while(next != nullptr)
+    {
+        current = next;
+        next = current->next.load(std::memory_order_relaxed);
+        current->data().~T();
+        NodeCache::release(current);
+    }
+}
+
+template<typename T>
+template<typename U>
+void MSQueue<T>::enqueue(U&& value)
+{
+    Node* node = NodeCache::acquire();
+    try
+    {
+        new (node->storage) T(std::forward<U>(value));
+    }
+    catch(...)
+    {
+        NodeCache::release(node);
+        throw;
+    }
+
+    while(true)
+    {
+        Node* last = HazardPointers::protect(0, tail);
+        Node* next = last->next.load(std::memory_order_acquire);
+        if(last != tail.load(std::memory_order_acquire))
+            continue;
+        if(next != nullptr)                                         ///tail is lagging - help it along
+        {
+            tail.compare_exchange_weak(last, next, std::memory_order_release, std::memory_order_relaxed);
+            continue;
+        }
+        if(last->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed))
+        {
+            tail.compare_exchange_strong(last, node, std::memory_order_release, std::memory_order_relaxed);
+            break;
+        }
+    }
+    HazardPointers::clear();
+}
+
+template<typename T>
+std::optional<T> MSQueue<T>::dequeue()
+{
+    while(true)
+    {
+        Node* first = HazardPointers::protect(0, head);
+        Node* last = tail.load(std::memory_order_acquire);
+        Node* next = first->next.load(std::memory_order_acquire);
+        HazardPointers::publish(1, next);
+        if(first != head.load(std::memory_order_seq_cst))           ///next may have been recycled meanwhile
+            continue;
+        if(next == nullptr)
+        {
+            HazardPointers::clear();
+            return std::nullopt;
+        }
+        if(first == last)                                           ///tail is lagging - help it along
+        {
+            tail.compare_exchange_weak(last, next, std::memory_order_release, std::memory_order_relaxed);
+            continue;
+        }
+        if(head.compare_exchange_strong(first, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            std::optional<T> result{std::move(next->data())};       ///only the winner touches the value
+            next->data().~T();
+            HazardPointers::clear();
+            HazardPointers::retire(first, &MSQueue::recycle);
+            return result;
+        }
+    }
+}
+
+template<typename T>
+bool MSQueue<T>::isEmpty() const
+{
+    Node* first = HazardPointers::protect(0, head);
+    bool empty = first->next.load(std::memory_order_acquire) == nullptr;
+    HazardPointers::clear();
+    return empty;
+}
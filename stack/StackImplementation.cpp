@@ -1,90 +1,377 @@
 #include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-template<typename T>
+/// Stack<T>            - heap backed, grows in chunks, nothing allocated while empty
+/// Stack<T, Capacity>  - fixed inline storage, push throws once Capacity is reached
+/// Either way elements are constructed on push and destroyed on pop.
+template<typename T, size_t InlineCapacity = 0>
 class Stack
 {
-    static const uint32_t MAX = 1000;
-
     protected:
-        T array[MAX];
-        int mtop{-1};
+        alignas(T) unsigned char storage[InlineCapacity * sizeof(T)];
+        size_t count{0};
+
+        T* items() { return std::launder(reinterpret_cast<T*>(storage)); }
+        const T* items() const { return std::launder(reinterpret_cast<const T*>(storage)); }
+
     public:
-        Stack(){};
-        ~Stack(){};
+        Stack() noexcept {};
+        ~Stack(){ clear(); };
         explicit Stack(const std::initializer_list<T>& init)
         {
-            for(const T& elem : init)
+            try
+            {
+                for(const T& elem : init)
+                {
+                    push(elem);
+                }
+            }
+            catch(...)
+            {
+                clear();
+                throw;
+            }
+        }
+        Stack(const Stack& src)
+        {
+            try
+            {
+                for(size_t i = 0; i < src.count; ++i)
+                {
+                    push(src.items()[i]);
+                }
+            }
+            catch(...)
             {
-                array[++mtop] = elem;
+                clear();
+                throw;
             }
-        }         
-        Stack(const Stack& src)                                       
+        }
+        Stack(Stack&& src) noexcept(std::is_nothrow_move_constructible_v<T>)
         {
-            mtop = src.mtop;
-            for(uint32_t i = 0; i < src.mtop; ++i)
+            if constexpr(std::is_nothrow_move_constructible_v<T>)      ///nothing to unwind
+            {
+                for(size_t i = 0; i < src.count; ++i)
+                {
+                    new (items() + i) T(std::move(src.items()[i]));
+                }
+                count = src.count;
+            }
+            else
             {
-                array[i] = src.array[i];
+                try
+                {
+                    for(size_t i = 0; i < src.count; ++i)
+                    {
+                        push(std::move(src.items()[i]));
+                    }
+                }
+                catch(...)
+                {
+                    clear();
+                    throw;
+                }
             }
+            src.clear();
         }
-        bool isEmpty()
+        bool isEmpty() const
         {
-            return mtop < 0;
+            return count == 0;
         }
         void push(const T& var)
         {
-            if(mtop >= MAX-1)
-                throw std::runtime_error("underflow");
-            array[++mtop] = var;
+            emplace(var);
+        }
+        void push(T&& var)
+        {
+            emplace(std::move(var));
+        }
+        template<typename... Args>
+        T& emplace(Args&&... args)
+        {
+            if(count == InlineCapacity)
+                throw std::runtime_error("overflow");
+            T* item = new (items() + count) T(std::forward<Args>(args)...);
+            ++count;
+            return *item;
         }
         void pop()
         {
-            if(mtop < 0)
+            if(count == 0)
                 throw std::runtime_error("underflow");
-            else
-                --mtop;
+            items()[--count].~T();
+        }
+        T& top()
+        {
+            if(count == 0)
+                throw std::runtime_error("underflow");
+            return items()[count - 1];
         }
         const T& top() const
         {
-            if(mtop < 0)
+            if(count == 0)
                 throw std::runtime_error("underflow");
-            return array[mtop];
+            return items()[count - 1];
+        }
+        size_t size() const
+        {
+            return count;
         }
-        uint32_t size() const
+        static constexpr size_t capacity()
         {
-            return mtop+1;
+            return InlineCapacity;
+        }
+        void clear()
+        {
+            while(count != 0)
+            {
+                items()[--count].~T();
+            }
         }
-        Stack<T>& operator=(const Stack<T>& rhs)
+        Stack& operator=(const Stack& rhs)
         {
             if(this == &rhs)
                 return *this;
-            mtop = rhs.mtop;
-            for(uint32_t i = 0; i <= rhs.mtop; ++i)
+            Stack tmp{rhs};
+            swap(tmp);
+            return *this;
+        }
+        Stack& operator=(Stack&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if(this == &rhs)
+                return *this;
+            clear();
+            for(size_t i = 0; i < rhs.count; ++i)
             {
-                push(rhs.array[i]);
+                new (items() + i) T(std::move(rhs.items()[i]));
+                ++count;                                                ///a throw leaves a valid prefix
             }
+            rhs.clear();
             return *this;
-        }  
-        void swap(Stack<T>& rhs) noexcept
+        }
+        void swap(Stack& rhs) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>)
+        {                                                               ///inline storage cannot trade pointers: TC n
+            size_t common = std::min(count, rhs.count);
+            for(size_t i = 0; i < common; ++i)
+            {
+                using std::swap;
+                swap(items()[i], rhs.items()[i]);
+            }
+            Stack& longer = count > rhs.count ? *this : rhs;
+            Stack& shorter = count > rhs.count ? rhs : *this;
+            for(size_t i = common; i < longer.count; ++i)
+            {
+                new (shorter.items() + i) T(std::move(longer.items()[i]));
+                longer.items()[i].~T();
+            }
+            std::swap(count, rhs.count);
+        }
+};
+
+template<typename T>
+class Stack<T, 0>
+{
+    protected:
+        struct Chunk
+        {
+            Chunk* below;
+            size_t capacity;
+        };
+        static constexpr size_t ITEMS_OFFSET = (sizeof(Chunk) + alignof(T) - 1) / alignof(T) * alignof(T);
+        static constexpr size_t FIRST_CHUNK = 8;                        /// elements
+        static constexpr size_t MAX_CHUNK = std::max<size_t>(FIRST_CHUNK, (64 * 1024) / sizeof(T));
+        static constexpr std::align_val_t CHUNK_ALIGN{std::max(alignof(Chunk), alignof(T))};
+
+        Chunk* current{nullptr};                                        /// top chunk, nullptr until the first push
+        Chunk* spare{nullptr};                                          /// last chunk popped empty, kept against push/pop thrash
+        size_t used{0};                                                 /// elements in current
+        size_t count{0};
+
+        static T* items(Chunk* chunk) { return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(chunk) + ITEMS_OFFSET); }
+        static const T* items(const Chunk* chunk) { return reinterpret_cast<const T*>(reinterpret_cast<const unsigned char*>(chunk) + ITEMS_OFFSET); }
+
+        static Chunk* allocateChunk(size_t capacity, Chunk* below)
+        {
+            void* memory = ::operator new(ITEMS_OFFSET + capacity * sizeof(T), CHUNK_ALIGN);
+            return new (memory) Chunk{below, capacity};
+        }
+        static void freeChunk(Chunk* chunk)
+        {
+            ::operator delete(static_cast<void*>(chunk), CHUNK_ALIGN);
+        }
+        void grow()                                                     /// opens an empty chunk on top
+        {
+            if(spare != nullptr)
+            {
+                spare->below = current;
+                current = std::exchange(spare, nullptr);
+            }
+            else
+            {
+                size_t capacity = current == nullptr ? FIRST_CHUNK : std::min(current->capacity * 2, MAX_CHUNK);
+                current = allocateChunk(capacity, current);
+            }
+            used = 0;
+        }
+        void shrink()                                                   /// current is empty and has a chunk below
+        {
+            if(spare != nullptr)
+                freeChunk(spare);
+            spare = current;
+            current = current->below;
+            used = current->capacity;
+        }
+        template<typename F>
+        void forEachBottomUp(F&& visit) const
+        {
+            std::vector<const Chunk*> chunks;
+            for(const Chunk* chunk = current; chunk != nullptr; chunk = chunk->below)
+                chunks.push_back(chunk);
+            for(size_t c = chunks.size(); c-- > 0;)
+            {
+                size_t filled = c == 0 ? used : chunks[c]->capacity;
+                for(size_t i = 0; i < filled; ++i)
+                    visit(items(chunks[c])[i]);
+            }
+        }
+
+    public:
+        Stack() noexcept {};
+        ~Stack(){ clear(); };
+        explicit Stack(const std::initializer_list<T>& init)
         {
-            uint32_t i = 0;
-            uint32_t j = 0;
-            while(i < size() && i < rhs.size())
-            {    
-                std::swap(array[i],rhs.array[i]);
-                ++i;
-                ++j;
+            try
+            {
+                for(const T& elem : init)
+                {
+                    push(elem);
+                }
+            }
+            catch(...)
+            {
+                clear();
+                throw;
             }
-            while(i < size())
+        }
+        Stack(const Stack& src)
+        {
+            try
             {
-                rhs.array[i] = array[i];
-                ++i;
+                src.forEachBottomUp([this](const T& elem) { push(elem); });
             }
-            while(j < size())
+            catch(...)
             {
-                array[j] = rhs.array[j];
-                ++j;
+                clear();
+                throw;
             }
-            std::swap(mtop,rhs.mtop);
-        } 
+        }
+        Stack(Stack&& src) noexcept
+        {
+            swap(src);
+        }
+        bool isEmpty() const
+        {
+            return count == 0;
+        }
+        void push(const T& var)
+        {
+            emplace(var);
+        }
+        void push(T&& var)
+        {
+            emplace(std::move(var));
+        }
+        template<typename... Args>
+        T& emplace(Args&&... args)
+        {
+            bool opened = current == nullptr || used == current->capacity;
+            if(opened)
+                grow();
+            try
+            {
+                T* item = new (items(current) + used) T(std::forward<Args>(args)...);
+                ++used;
+                ++count;
+                return *item;
+            }
+            catch(...)
+            {
+                if(opened && current->below != nullptr)
+                    shrink();
+                throw;
+            }
+        }
+        void pop()
+        {
+            if(count == 0)
+                throw std::runtime_error("underflow");
+            items(current)[--used].~T();
+            --count;
+            if(used == 0 && current->below != nullptr)
+                shrink();
+        }
+        T& top()
+        {
+            if(count == 0)
+                throw std::runtime_error("underflow");
+            return items(current)[used - 1];
+        }
+        const T& top() const
+        {
+            if(count == 0)
+                throw std::runtime_error("underflow");
+            return items(current)[used - 1];
+        }
+        size_t size() const
+        {
+            return count;
+        }
+        void clear()                                                    /// also returns every chunk
+        {
+            while(current != nullptr)
+            {
+                while(used != 0)
+                {
+                    items(current)[--used].~T();
+                }
+                Chunk* below = current->below;
+                freeChunk(current);
+                current = below;
+                used = current != nullptr ? current->capacity : 0;
+            }
+            if(spare != nullptr)
+                freeChunk(std::exchange(spare, nullptr));
+            count = 0;
+        }
+        Stack& operator=(const Stack& rhs)
+        {
+            if(this == &rhs)
+                return *this;
+            Stack tmp{rhs};
+            swap(tmp);
+            return *this;
+        }
+        Stack& operator=(Stack&& rhs) noexcept
+        {
+            if(this == &rhs)
+                return *this;
+            clear();
+            swap(rhs);
+            return *this;
+        }
+        void swap(Stack& rhs) noexcept                                  ///TC 1, only the chunk pointers move
+        {
+            std::swap(current, rhs.current);
+            std::swap(spare, rhs.spare);
+            std::swap(used, rhs.used);
+            std::swap(count, rhs.count);
+        }
 };
-